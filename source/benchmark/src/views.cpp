@@ -0,0 +1,166 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file views.cpp
+/// @brief Compares the range adaptors of `sensor/views/adaptors.hpp` with the equivalent hand-written loops,
+/// checking that both produce the same results and printing the best of several timed runs of each.
+#include <kmx/sensor/data/temperature.hpp>
+#include <kmx/sensor/views/adaptors.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace kmx::sensor;
+    using traits = data::temperature::traits_type;
+    using sensor_type = data::temperature;
+    using storage_type = traits::storage_type;
+
+    constexpr std::size_t count = 10'000'000u;
+    constexpr int runs = 5;
+
+    /// @brief Runs a function several times and returns its result and the best time in milliseconds.
+    template <typename function>
+    auto measure(function&& run)
+    {
+        auto result = run();
+        double best = std::numeric_limits<double>::max();
+        for (int i {}; i < runs; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            result = run();
+            const auto stop = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+        }
+
+        return std::pair {result, best};
+    }
+
+    /// @brief Times a hand-written loop and an adaptor pipeline computing the same result.
+    /// @return True if both results are equal.
+    template <typename loop_function, typename view_function>
+    bool compare(const char* const name, loop_function&& loop, view_function&& view)
+    {
+        const auto [loop_result, loop_time] = measure(loop);
+        const auto [view_result, view_time] = measure(view);
+        const bool equal = loop_result == view_result;
+        std::printf("%-36s loop %8.2f ms  view %8.2f ms  ratio %5.2f  %s\n", name, loop_time, view_time, view_time / loop_time,
+                    equal ? "ok" : "MISMATCH");
+        return equal;
+    }
+
+} // namespace
+
+int main()
+{
+    std::mt19937 engine {42u};
+    std::uniform_int_distribution<int> raw_distribution {-700, 700};
+    std::uniform_real_distribution<float> physical_distribution {-70.0f, 70.0f};
+
+    // Raw columns as received: one with many out-of-range values, one that is mostly valid.
+    std::vector<storage_type> raw(count);
+    std::vector<storage_type> mostly_valid(count);
+    std::vector<float> physical(count);
+    for (std::size_t i {}; i < count; ++i)
+    {
+        raw[i] = static_cast<storage_type>(raw_distribution(engine));
+        mostly_valid[i] = (i % 1000u == 7u) ? storage_type {600} : static_cast<storage_type>(raw[i] % 500);
+        physical[i] = physical_distribution(engine);
+    }
+
+    std::vector<sensor_type> readings(count / 10u);
+    for (std::size_t i {}; i < readings.size(); i += 2u)
+        (void) readings[i].set_raw_scaled_value(mostly_valid[i]);
+
+    bool ok = true;
+
+    ok &= compare(
+        "physical: sum of raw column",
+        [&]
+        {
+            double sum {};
+            for (std::size_t i {}; i < raw.size(); ++i)
+                sum += sensor_type::to_physical(raw[i]);
+            return sum;
+        },
+        [&]
+        {
+            double sum {};
+            for (const float val: raw | views::physical<traits>)
+                sum += val;
+            return sum;
+        });
+
+    ok &= compare(
+        "scaled: sum of physical column",
+        [&]
+        {
+            std::int64_t sum {};
+            for (std::size_t i {}; i < physical.size(); ++i)
+                sum += sensor_type::to_scaled(physical[i]);
+            return sum;
+        },
+        [&]
+        {
+            std::int64_t sum {};
+            for (const storage_type val: physical | views::scaled<traits>)
+                sum += val;
+            return sum;
+        });
+
+    ok &= compare(
+        "clamped_count: physical column",
+        [&]
+        {
+            std::size_t total {};
+            for (std::size_t i {}; i < physical.size(); ++i)
+                total += static_cast<std::size_t>((physical[i] < traits::min_value) | (physical[i] > traits::max_value));
+            return total;
+        },
+        [&] { return physical | views::clamped_count<traits>; });
+
+    ok &= compare(
+        "valid_only | physical: mostly valid",
+        [&]
+        {
+            double sum {};
+            for (std::size_t i {}; i < mostly_valid.size(); ++i)
+                if ((mostly_valid[i] >= sensor_type::min_scaled_storage_value()) &&
+                    (mostly_valid[i] <= sensor_type::max_scaled_storage_value()))
+                    sum += sensor_type::to_physical(mostly_valid[i]);
+            return sum;
+        },
+        [&]
+        {
+            double sum {};
+            for (const float val: mostly_valid | views::valid_only<traits> | views::physical<traits>)
+                sum += val;
+            return sum;
+        });
+
+    ok &= compare(
+        "valid_only | physical: readings",
+        [&]
+        {
+            double sum {};
+            for (const sensor_type& reading: readings)
+                if (reading)
+                    sum += *reading.value();
+            return sum;
+        },
+        [&]
+        {
+            double sum {};
+            for (const float val: readings | views::valid_only<traits> | views::physical<traits>)
+                sum += val;
+            return sum;
+        });
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,167 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/analysis/correlation.hpp
+/// @brief Defines the all-pairs Pearson correlation matrix of aligned sensor columns, computed as
+/// cache-blocked dot products of centered, normalized scaled values on worker threads.
+#pragma once
+#ifndef PCH
+    #include <algorithm>
+    #include <array>
+    #include <atomic>
+    #include <cmath>
+    #include <cstddef>
+    #include <span>
+    #include <thread>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::analysis
+{
+    /// @brief A symmetric matrix of correlation coefficients between sensors.
+    class correlation_matrix
+    {
+    public:
+        /// @brief The number of sensors per tile side.
+        static constexpr std::size_t tile_sensors = 64u;
+        /// @brief The number of samples per tile depth; a 64 × 512 tile of floats is 128 KiB.
+        static constexpr std::size_t tile_samples = 512u;
+
+        /// @brief Computes the correlations between all pairs of aligned columns.
+        /// @details Each column is centered, scaled to unit length and stored as a padded float row, so a
+        ///          coefficient is a single dot product. The upper triangle is split into tiles of
+        ///          `tile_sensors` × `tile_sensors` pairs that worker threads take from a shared counter; each
+        ///          tile is walked in slices of `tile_samples` so that both row blocks stay in cache. Columns
+        ///          that do not vary correlate 0 with everything, including themselves.
+        /// @tparam storage_type The raw scaled value type.
+        /// @param columns The sensor columns; all must have the same length (longer ones are truncated).
+        /// @param threads The number of worker threads (0 selects the hardware concurrency).
+        template <typename storage_type>
+        [[nodiscard]] static correlation_matrix compute(const std::span<const std::span<const storage_type>> columns, unsigned threads = 0u)
+        {
+            correlation_matrix result {columns.size()};
+            if (columns.empty())
+                return result;
+
+            std::size_t samples = columns.front().size();
+            for (const auto& column: columns)
+                samples = std::min(samples, column.size());
+
+            const std::size_t stride = (samples + lanes - 1u) / lanes * lanes;
+            std::vector<float> rows(columns.size() * stride);
+            for (std::size_t i {}; i < columns.size(); ++i)
+                normalize(columns[i].first(samples), std::span {rows}.subspan(i * stride, stride));
+
+            const std::size_t blocks = (columns.size() + tile_sensors - 1u) / tile_sensors;
+            std::vector<std::pair<std::size_t, std::size_t>> tiles;
+            for (std::size_t i {}; i < blocks; ++i)
+                for (std::size_t j = i; j < blocks; ++j)
+                    tiles.emplace_back(i, j);
+
+            std::atomic<std::size_t> next {};
+            const auto work = [&]
+            {
+                for (std::size_t tile = next++; tile < tiles.size(); tile = next++)
+                    result.compute_tile(rows, stride, tiles[tile].first, tiles[tile].second);
+            };
+
+            if (threads == 0u)
+                threads = std::max(std::thread::hardware_concurrency(), 1u);
+            threads = static_cast<unsigned>(std::min<std::size_t>(threads, tiles.size()));
+            if (threads <= 1u)
+                work();
+            else
+            {
+                std::vector<std::jthread> workers;
+                workers.reserve(threads);
+                for (unsigned t {}; t < threads; ++t)
+                    workers.emplace_back(work);
+            }
+
+            return result;
+        }
+
+        /// @brief Gets the number of sensors.
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+        /// @brief Gets the correlation coefficient of two sensors.
+        [[nodiscard]] float operator()(const std::size_t row, const std::size_t column) const noexcept
+        {
+            return values_[(row * size_) + column];
+        }
+
+        /// @brief Gets all coefficients in row-major order.
+        [[nodiscard]] std::span<const float> values() const noexcept { return values_; }
+
+    private:
+        static constexpr std::size_t lanes = 16u;
+
+        explicit correlation_matrix(const std::size_t size): size_ {size}, values_(size * size) {}
+
+        template <typename storage_type>
+        static void normalize(const std::span<const storage_type> column, const std::span<float> row) noexcept
+        {
+            double total {};
+            for (const storage_type val: column)
+                total += static_cast<double>(val);
+            const double mean = column.empty() ? 0.0 : total / static_cast<double>(column.size());
+
+            double energy {};
+            for (const storage_type val: column)
+                energy += (static_cast<double>(val) - mean) * (static_cast<double>(val) - mean);
+
+            // Scaling does not change a correlation, so the resolution of the sensor type is irrelevant.
+            const double scale = (energy > 0.0) ? 1.0 / std::sqrt(energy) : 0.0;
+            for (std::size_t i {}; i < column.size(); ++i)
+                row[i] = static_cast<float>((static_cast<double>(column[i]) - mean) * scale);
+        }
+
+        // Independent lane accumulators let compilers vectorize the reduction without reassociating it.
+        [[nodiscard]] static float dot(const float* const first, const float* const second, const std::size_t count) noexcept
+        {
+            std::array<float, lanes> sums {};
+            for (std::size_t i {}; i < count; i += lanes)
+                for (std::size_t lane {}; lane < lanes; ++lane)
+                    sums[lane] += first[i + lane] * second[i + lane];
+
+            float total {};
+            for (const float sum: sums)
+                total += sum;
+            return total;
+        }
+
+        void compute_tile(const std::vector<float>& rows, const std::size_t stride, const std::size_t block_row,
+                          const std::size_t block_column) noexcept
+        {
+            const std::size_t row_begin = block_row * tile_sensors;
+            const std::size_t row_end = std::min(row_begin + tile_sensors, size_);
+            const std::size_t column_begin = block_column * tile_sensors;
+            const std::size_t column_end = std::min(column_begin + tile_sensors, size_);
+
+            std::array<double, tile_sensors * tile_sensors> sums {};
+            for (std::size_t depth {}; depth < stride; depth += tile_samples)
+            {
+                const std::size_t count = std::min(tile_samples, stride - depth);
+                for (std::size_t i = row_begin; i < row_end; ++i)
+                {
+                    const float* const first = rows.data() + (i * stride) + depth;
+                    double* const row_sums = sums.data() + ((i - row_begin) * tile_sensors);
+                    for (std::size_t j = std::max(column_begin, i); j < column_end; ++j)
+                        row_sums[j - column_begin] += dot(first, rows.data() + (j * stride) + depth, count);
+                }
+            }
+
+            for (std::size_t i = row_begin; i < row_end; ++i)
+                for (std::size_t j = std::max(column_begin, i); j < column_end; ++j)
+                {
+                    const double sum = sums[((i - row_begin) * tile_sensors) + (j - column_begin)];
+                    const auto coefficient = static_cast<float>(std::clamp(sum, -1.0, 1.0));
+                    values_[(i * size_) + j] = coefficient;
+                    values_[(j * size_) + i] = coefficient;
+                }
+        }
+
+        std::size_t size_;
+        std::vector<float> values_;
+    };
+
+} // namespace sensor::analysis
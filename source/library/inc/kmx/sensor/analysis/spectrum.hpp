@@ -0,0 +1,336 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/analysis/spectrum.hpp
+/// @brief Defines a radix-2 real FFT for power-of-two windows of scaled sensor data, and power
+/// spectrum and FFT-based cross-correlation helpers that run batched over many sensors.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/base.hpp>
+    #include <algorithm>
+    #include <bit>
+    #include <cmath>
+    #include <complex>
+    #include <cstddef>
+    #include <cstdint>
+    #include <numbers>
+    #include <span>
+    #include <thread>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::analysis
+{
+    /// @brief A precomputed plan for forward and inverse FFTs of real signals of a power-of-two length.
+    /// @details A real signal of length n is transformed as a complex signal of length n / 2 (even
+    ///          samples as real parts, odd samples as imaginary parts) followed by a split step, which
+    ///          halves the work of a complex FFT. Twiddle factors and the bit-reversal permutation are
+    ///          computed once per plan. A plan keeps scratch space, so each thread needs its own copy.
+    class real_fft
+    {
+    public:
+        using complex_type = std::complex<double>;
+
+        /// @brief Constructor.
+        /// @param size The signal length; a power of two of at least 2.
+        explicit real_fft(const std::size_t size):
+            size_ {std::max<std::size_t>(std::bit_ceil(size), 2u)}, half_ {size_ / 2u}, reversed_(half_), twiddles_(size_ / 2u),
+            scratch_(half_)
+        {
+            const unsigned bits = static_cast<unsigned>(std::countr_zero(half_));
+            for (std::size_t i {}; i < half_; ++i)
+                reversed_[i] = (bits == 0u) ? 0u : (reverse_bits(i) >> (64u - bits));
+
+            // Twiddles of the length n transform; the half-length transform uses every second one.
+            for (std::size_t k {}; k < twiddles_.size(); ++k)
+                twiddles_[k] = std::polar(1.0, -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(size_));
+        }
+
+        /// @brief Gets the signal length.
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+        /// @brief Gets the number of frequency bins of a transform, n / 2 + 1.
+        [[nodiscard]] std::size_t bins() const noexcept { return half_ + 1u; }
+
+        /// @brief Transforms a real signal into its non-negative frequency bins.
+        /// @param input The signal; shorter signals are zero-padded.
+        /// @param output The bins; must hold `bins()` values.
+        void forward(const std::span<const double> input, const std::span<complex_type> output)
+        {
+            for (std::size_t i {}; i < half_; ++i)
+            {
+                const std::size_t even = 2u * i;
+                scratch_[i] = {(even < input.size()) ? input[even] : 0.0, (even + 1u < input.size()) ? input[even + 1u] : 0.0};
+            }
+            transform(scratch_);
+
+            for (std::size_t k {}; k <= half_; ++k)
+            {
+                const complex_type z = scratch_[k % half_];
+                const complex_type mirrored = std::conj(scratch_[(half_ - k) % half_]);
+                const complex_type even = 0.5 * (z + mirrored);
+                const complex_type odd = complex_type {0.0, -0.5} * (z - mirrored);
+                output[k] = even + (twiddle(k) * odd);
+            }
+        }
+
+        /// @brief Transforms non-negative frequency bins back into a real signal.
+        /// @param input The bins; must hold `bins()` values.
+        /// @param output The signal; must hold `size()` values.
+        void inverse(const std::span<const complex_type> input, const std::span<double> output)
+        {
+            for (std::size_t k {}; k < half_; ++k)
+            {
+                const complex_type x = input[k];
+                const complex_type mirrored = std::conj(input[half_ - k]);
+                const complex_type even = 0.5 * (x + mirrored);
+                const complex_type odd = 0.5 * (x - mirrored) * std::conj(twiddle(k));
+                // Conjugating around a forward transform yields the inverse one.
+                scratch_[k] = std::conj(even + (complex_type {0.0, 1.0} * odd));
+            }
+            transform(scratch_);
+
+            const double scale = 1.0 / static_cast<double>(half_);
+            for (std::size_t i {}; i < half_; ++i)
+            {
+                output[2u * i] = scratch_[i].real() * scale;
+                output[(2u * i) + 1u] = -scratch_[i].imag() * scale;
+            }
+        }
+
+    private:
+        [[nodiscard]] static constexpr std::uint64_t reverse_bits(std::uint64_t val) noexcept
+        {
+            std::uint64_t result {};
+            for (unsigned i {}; i < 64u; ++i, val >>= 1u)
+                result = (result << 1u) | (val & 1u);
+            return result;
+        }
+
+        [[nodiscard]] complex_type twiddle(const std::size_t k) const noexcept
+        {
+            return (k < twiddles_.size()) ? twiddles_[k] : -twiddles_[k - twiddles_.size()];
+        }
+
+        // Iterative in-place radix-2 decimation-in-time FFT of length n / 2.
+        void transform(std::vector<complex_type>& data) const noexcept
+        {
+            for (std::size_t i {}; i < half_; ++i)
+                if (i < reversed_[i])
+                    std::swap(data[i], data[reversed_[i]]);
+
+            for (std::size_t length {2u}; length <= half_; length <<= 1u)
+            {
+                const std::size_t middle = length / 2u;
+                const std::size_t stride = size_ / length;
+                for (std::size_t start {}; start < half_; start += length)
+                    for (std::size_t j {}; j < middle; ++j)
+                    {
+                        const complex_type u = data[start + j];
+                        const complex_type v = data[start + j + middle] * twiddles_[j * stride];
+                        data[start + j] = u + v;
+                        data[start + j + middle] = u - v;
+                    }
+            }
+        }
+
+        std::size_t size_;
+        std::size_t half_;
+        std::vector<std::size_t> reversed_;
+        std::vector<complex_type> twiddles_;
+        std::vector<complex_type> scratch_;
+    };
+
+    /// @brief Converts a window of scaled values to physical values with their mean removed.
+    template <typename traits>
+    void center(const std::span<const typename traits::storage_type> values, std::vector<double>& output)
+    {
+        output.resize(values.size());
+        double total {};
+        for (const auto val: values)
+            total += static_cast<double>(val);
+
+        const double mean = values.empty() ? 0.0 : total / static_cast<double>(values.size());
+        const auto resolution = static_cast<double>(traits::resolution);
+        for (std::size_t i {}; i < values.size(); ++i)
+            output[i] = (static_cast<double>(values[i]) - mean) * resolution;
+    }
+
+    /// @brief Computes the periodogram of a window of scaled values, in squared physical units.
+    /// @param plan The FFT plan; its size is the window length (shorter windows are zero-padded).
+    /// @param values The scaled values; their mean is removed first.
+    /// @param power The power of each frequency bin; must hold `plan.bins()` values.
+    template <typename traits>
+    void power_spectrum(real_fft& plan, const std::span<const typename traits::storage_type> values, const std::span<double> power)
+    {
+        std::vector<double> signal;
+        center<traits>(values, signal);
+        std::vector<real_fft::complex_type> bins(plan.bins());
+        plan.forward(signal, bins);
+
+        const double scale = 1.0 / static_cast<double>(plan.size());
+        for (std::size_t k {}; k < bins.size(); ++k)
+            power[k] = std::norm(bins[k]) * scale;
+    }
+
+    /// @brief Computes the periodograms of windows of many sensors on worker threads.
+    /// @param plan The FFT plan, copied per worker thread.
+    /// @param windows The scaled values of every sensor.
+    /// @param power The bins of every sensor, row by row; must hold `windows.size() * plan.bins()` values.
+    /// @param threads The number of worker threads (0 selects the hardware concurrency).
+    template <typename traits>
+    void power_spectra(const real_fft& plan, const std::span<const std::span<const typename traits::storage_type>> windows,
+                       const std::span<double> power, unsigned threads = 0u)
+    {
+        const std::size_t bins = plan.bins();
+        const auto work = [&](const std::size_t from, const std::size_t to)
+        {
+            real_fft local {plan};
+            for (std::size_t i = from; i < to; ++i)
+                power_spectrum<traits>(local, windows[i], power.subspan(i * bins, bins));
+        };
+
+        if (threads == 0u)
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, windows.size()));
+        if (threads <= 1u)
+        {
+            work(0u, windows.size());
+            return;
+        }
+
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (unsigned t {}; t < threads; ++t)
+            workers.emplace_back(work, windows.size() * t / threads, windows.size() * (t + 1u) / threads);
+    }
+
+    /// @brief Computes normalized cross-correlations of windows of scaled values in O(n log n).
+    /// @details Both windows are centered and zero-padded to a power of two of at least twice their
+    ///          length, so the correlation is linear rather than circular. A positive lag means the
+    ///          second signal follows the first one (e.g. room temperature following the HVAC supply).
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class cross_correlation
+    {
+    public:
+        using storage_type = typename traits::storage_type;
+
+        /// @brief Constructor.
+        /// @param length The window length of both signals; 0 is raised to 1.
+        explicit cross_correlation(const std::size_t length): length_ {std::max<std::size_t>(length, 1u)}, plan_ {2u * length_} {}
+
+        /// @brief Gets the window length.
+        [[nodiscard]] std::size_t length() const noexcept { return length_; }
+
+        /// @brief Correlates two windows.
+        /// @param first The first signal.
+        /// @param second The second signal.
+        /// @param output The correlation coefficients in [-1, 1] for lags -(length - 1) ... (length - 1),
+        ///               stored at index `lag + length - 1`; must hold `2 * length - 1` values.
+        void correlate(const std::span<const storage_type> first, const std::span<const storage_type> second,
+                       const std::span<double> output)
+        {
+            spectrum(first, first_bins_);
+            correlate(first_bins_, energy(), second, output);
+        }
+
+        /// @brief Finds the lag at which two windows correlate best.
+        /// @param max_lag The largest lag considered in either direction.
+        /// @return The lag in samples; 0 if neither signal varies.
+        [[nodiscard]] std::ptrdiff_t lag(const std::span<const storage_type> first, const std::span<const storage_type> second,
+                                         const std::size_t max_lag)
+        {
+            spectrum(first, first_bins_);
+            return best_lag(first_bins_, energy(), second, max_lag);
+        }
+
+        /// @brief Finds the lags of many windows against one reference window on worker threads.
+        /// @param reference The reference signal, transformed once.
+        /// @param others The signals to align with it.
+        /// @param lags The lag of every other signal; must be as large as `others`.
+        /// @param max_lag The largest lag considered in either direction.
+        /// @param threads The number of worker threads (0 selects the hardware concurrency).
+        void lags(const std::span<const storage_type> reference, const std::span<const std::span<const storage_type>> others,
+                  const std::span<std::ptrdiff_t> lags, const std::size_t max_lag, unsigned threads = 0u)
+        {
+            spectrum(reference, first_bins_);
+            const double reference_energy = energy();
+            const auto work = [&](const std::size_t from, const std::size_t to)
+            {
+                cross_correlation local {*this};
+                for (std::size_t i = from; i < to; ++i)
+                    lags[i] = local.best_lag(first_bins_, reference_energy, others[i], max_lag);
+            };
+
+            if (threads == 0u)
+                threads = std::max(std::thread::hardware_concurrency(), 1u);
+            threads = static_cast<unsigned>(std::min<std::size_t>(threads, others.size()));
+            if (threads <= 1u)
+            {
+                work(0u, others.size());
+                return;
+            }
+
+            std::vector<std::jthread> workers;
+            workers.reserve(threads);
+            for (unsigned t {}; t < threads; ++t)
+                workers.emplace_back(work, others.size() * t / threads, others.size() * (t + 1u) / threads);
+        }
+
+    private:
+        void spectrum(const std::span<const storage_type> values, std::vector<real_fft::complex_type>& bins)
+        {
+            center<traits>(values.first(std::min(values.size(), length_)), signal_);
+            energy_ = 0.0;
+            for (const double val: signal_)
+                energy_ += val * val;
+            bins.resize(plan_.bins());
+            plan_.forward(signal_, bins);
+        }
+
+        [[nodiscard]] double energy() const noexcept { return energy_; }
+
+        void correlate(const std::vector<real_fft::complex_type>& first_bins, const double first_energy,
+                       const std::span<const storage_type> second, const std::span<double> output)
+        {
+            spectrum(second, second_bins_);
+            for (std::size_t k {}; k < second_bins_.size(); ++k)
+                second_bins_[k] *= std::conj(first_bins[k]);
+            raw_.resize(plan_.size());
+            plan_.inverse(second_bins_, raw_);
+
+            const double norm = std::sqrt(first_energy * energy_);
+            const double scale = (norm > 0.0) ? 1.0 / norm : 0.0;
+            for (std::size_t i {}; i + 1u < 2u * length_; ++i)
+            {
+                // Negative lags wrap around to the end of the circular result.
+                const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(i) - static_cast<std::ptrdiff_t>(length_ - 1u);
+                const std::size_t index = (lag < 0) ? plan_.size() - static_cast<std::size_t>(-lag) : static_cast<std::size_t>(lag);
+                output[i] = raw_[index] * scale;
+            }
+        }
+
+        [[nodiscard]] std::ptrdiff_t best_lag(const std::vector<real_fft::complex_type>& first_bins, const double first_energy,
+                                              const std::span<const storage_type> second, const std::size_t max_lag)
+        {
+            coefficients_.resize((2u * length_) - 1u);
+            correlate(first_bins, first_energy, second, coefficients_);
+
+            const std::size_t reach = std::min(max_lag, length_ - 1u);
+            std::size_t best = length_ - 1u;
+            for (std::size_t i = length_ - 1u - reach; i <= length_ - 1u + reach; ++i)
+                if (coefficients_[i] > coefficients_[best])
+                    best = i;
+            return static_cast<std::ptrdiff_t>(best) - static_cast<std::ptrdiff_t>(length_ - 1u);
+        }
+
+        std::size_t length_;
+        real_fft plan_;
+        double energy_ {};
+        std::vector<double> signal_;
+        std::vector<double> raw_;
+        std::vector<double> coefficients_;
+        std::vector<real_fft::complex_type> first_bins_;
+        std::vector<real_fft::complex_type> second_bins_;
+    };
+
+} // namespace sensor::analysis
@@ -0,0 +1,171 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/calibration/linearization.hpp
+/// @brief Defines piecewise-linear linearization tables that map raw readings of nonlinear sensors
+/// (thermistors, photodiodes, ...) straight to scaled values, generated at compile time.
+/// Interpolation runs in 16.16 fixed point; the batch conversions are branch-free loops over a
+/// whole input buffer that compilers vectorize.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/base.hpp>
+    #include <algorithm>
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #include <utility>
+#endif
+
+namespace kmx::sensor::calibration
+{
+    /// @brief Converts a physical value to a scaled value in 16.16 fixed point.
+    template <data::integer_scaled traits>
+    [[nodiscard]] constexpr std::int64_t to_fixed_scaled(const typename traits::input_type val) noexcept
+    {
+        const double scaled = static_cast<double>(val) / static_cast<double>(traits::resolution) * 65536.0;
+        return static_cast<std::int64_t>(scaled + ((scaled >= 0.0) ? 0.5 : -0.5));
+    }
+
+    /// @brief Rounds a 16.16 fixed point scaled value and clamps it to the valid scaled range.
+    template <data::integer_scaled traits>
+    [[nodiscard]] constexpr typename traits::storage_type from_fixed_scaled(const std::int64_t val) noexcept
+    {
+        using sensor_type = data::base<traits>;
+        const std::int64_t scaled = (val + 0x8000) >> 16;
+        return static_cast<typename traits::storage_type>(std::clamp<std::int64_t>(scaled, sensor_type::min_scaled_storage_value(),
+                                                                                   sensor_type::max_scaled_storage_value()));
+    }
+
+    /// @brief A linearization table with equally spaced breakpoints over a `raw_bits`-bit raw domain
+    ///        (e.g. the codes of an ADC).
+    /// @details The raw domain is split into 2^segment_bits segments, so the segment of a reading is found
+    ///          with a shift and the interpolation divides by a power of two: `raw -> scaled` costs two table
+    ///          loads, a multiply and two shifts. Breakpoints are sampled from a physical transfer function:
+    ///          @code
+    ///          constexpr auto ntc = calibration::uniform_table<data::temperature_traits, 12u, 6u> {
+    ///              [](const std::uint32_t code) { return steinhart_hart(code); }};
+    ///          @endcode
+    /// @tparam traits The traits of the sensor type produced.
+    /// @tparam raw_bits The number of significant bits of a raw reading.
+    /// @tparam segment_bits The binary logarithm of the number of segments.
+    /// @tparam raw_type The type of a raw reading.
+    template <data::integer_scaled traits, unsigned raw_bits, unsigned segment_bits, typename raw_type = std::uint16_t>
+    class uniform_table
+    {
+    public:
+        static_assert((segment_bits <= raw_bits) && (raw_bits <= 24u), "invalid table geometry");
+
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+
+        /// @brief The number of segments.
+        static constexpr std::size_t segments = std::size_t {1u} << segment_bits;
+        /// @brief The shift from a raw reading to its segment.
+        static constexpr unsigned shift = raw_bits - segment_bits;
+        /// @brief The largest raw reading; larger readings are clamped to it.
+        static constexpr std::uint32_t max_raw = (std::uint32_t {1u} << raw_bits) - 1u;
+
+        /// @brief Constructor sampling a transfer function at the segment boundaries.
+        /// @param transfer Callable `input_type(std::uint32_t raw)` returning the physical value of a raw reading.
+        ///                 The boundary after the last segment is sampled at 2^raw_bits.
+        template <typename function>
+        constexpr explicit uniform_table(function&& transfer) noexcept
+        {
+            std::int64_t previous = to_fixed_scaled<traits>(transfer(0u));
+            for (std::size_t i {}; i < segments; ++i)
+            {
+                const std::int64_t next = to_fixed_scaled<traits>(transfer(static_cast<std::uint32_t>((i + 1u) << shift)));
+                origin_[i] = previous;
+                rise_[i] = next - previous;
+                previous = next;
+            }
+        }
+
+        /// @brief Converts one raw reading.
+        [[nodiscard]] constexpr storage_type operator()(const raw_type raw) const noexcept
+        {
+            const std::uint32_t code = std::min<std::uint32_t>(raw, max_raw);
+            const std::uint32_t segment = code >> shift;
+            const std::int64_t offset = code & ((std::uint32_t {1u} << shift) - 1u);
+            return from_fixed_scaled<traits>(origin_[segment] + ((offset * rise_[segment]) >> shift));
+        }
+
+        /// @brief Converts a buffer of raw readings in one pass.
+        /// @param input The raw readings (e.g. a DMA buffer).
+        /// @param output The scaled values; must be at least as large as `input`.
+        constexpr void convert(const std::span<const raw_type> input, const std::span<storage_type> output) const noexcept
+        {
+            const std::size_t count = std::min(input.size(), output.size());
+            for (std::size_t i {}; i < count; ++i)
+                output[i] = (*this)(input[i]);
+        }
+
+    private:
+        std::array<std::int64_t, segments> origin_ {};
+        std::array<std::int64_t, segments> rise_ {};
+    };
+
+    /// @brief A linearization table with arbitrary breakpoints, e.g. taken from a datasheet.
+    /// @details The segment of a reading is found by counting the inner breakpoints at or below it,
+    ///          a branch-free compare-and-add over a small array instead of a branchy binary search.
+    ///          Readings outside the first and last breakpoint are clamped to them.
+    /// @tparam traits The traits of the sensor type produced.
+    /// @tparam points The number of breakpoints (at least 2).
+    /// @tparam raw_type The type of a raw reading.
+    template <data::integer_scaled traits, std::size_t points, typename raw_type = std::uint16_t>
+    class breakpoint_table
+    {
+    public:
+        static_assert(points >= 2u, "a table needs at least two breakpoints");
+
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using input_type = typename traits::input_type;
+        using breakpoint = std::pair<raw_type, input_type>;
+
+        /// @brief Constructor.
+        /// @param breakpoints The (raw reading, physical value) pairs in strictly increasing raw order.
+        constexpr explicit breakpoint_table(const std::array<breakpoint, points>& breakpoints) noexcept
+        {
+            for (std::size_t i {}; i < points; ++i)
+                raw_[i] = breakpoints[i].first;
+
+            for (std::size_t i {}; i + 1u < points; ++i)
+            {
+                const std::int64_t from = to_fixed_scaled<traits>(breakpoints[i].second);
+                const std::int64_t to = to_fixed_scaled<traits>(breakpoints[i + 1u].second);
+                const std::int64_t width = static_cast<std::int64_t>(raw_[i + 1u]) - raw_[i];
+                origin_[i] = from;
+                // 16 more fractional bits keep the per-code slope precise for wide segments.
+                slope_[i] = ((to - from) * 65536 + (width / 2)) / width;
+            }
+        }
+
+        /// @brief Converts one raw reading.
+        [[nodiscard]] constexpr storage_type operator()(const raw_type raw) const noexcept
+        {
+            const std::int64_t code = std::clamp<std::int64_t>(raw, raw_.front(), raw_.back());
+            std::size_t segment {};
+            for (std::size_t i {1u}; i + 1u < points; ++i)
+                segment += (code >= raw_[i]) ? 1u : 0u;
+
+            const std::int64_t offset = code - raw_[segment];
+            return from_fixed_scaled<traits>(origin_[segment] + ((offset * slope_[segment] + 0x8000) >> 16));
+        }
+
+        /// @brief Converts a buffer of raw readings in one pass.
+        /// @param input The raw readings (e.g. a DMA buffer).
+        /// @param output The scaled values; must be at least as large as `input`.
+        constexpr void convert(const std::span<const raw_type> input, const std::span<storage_type> output) const noexcept
+        {
+            const std::size_t count = std::min(input.size(), output.size());
+            for (std::size_t i {}; i < count; ++i)
+                output[i] = (*this)(input[i]);
+        }
+
+    private:
+        std::array<std::int64_t, points> raw_ {};
+        std::array<std::int64_t, points - 1u> origin_ {};
+        std::array<std::int64_t, points - 1u> slope_ {};
+    };
+
+} // namespace sensor::calibration
@@ -0,0 +1,50 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/codec/hash.hpp
+/// @brief Defines a fast, non-cryptographic 64-bit hash over byte buffers, used for integrity
+/// checks and content fingerprints.
+#pragma once
+#ifndef PCH
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <span>
+#endif
+
+namespace kmx::sensor::codec
+{
+    /// @brief Finalizes a 64-bit hash state so that every input bit affects every output bit.
+    [[nodiscard]] constexpr std::uint64_t mix(std::uint64_t val) noexcept
+    {
+        val ^= val >> 33u;
+        val *= 0xff51afd7ed558ccdu;
+        val ^= val >> 33u;
+        val *= 0xc4ceb9fe1a85ec53u;
+        val ^= val >> 33u;
+        return val;
+    }
+
+    /// @brief Hashes a byte buffer, eight bytes at a time.
+    /// @details Not suitable against adversarial inputs; intended to detect corruption and to compare
+    ///          content between trusted stores.
+    /// @param bytes The bytes to hash.
+    /// @param seed An optional seed, e.g. to chain hashes of several buffers.
+    /// @return The 64-bit hash.
+    [[nodiscard]] inline std::uint64_t hash_bytes(const std::span<const std::byte> bytes, const std::uint64_t seed = 0u) noexcept
+    {
+        constexpr std::uint64_t prime = 0x9e3779b97f4a7c15u;
+        std::uint64_t state = seed ^ (bytes.size() * prime);
+        std::size_t i {};
+        for (; i + sizeof(std::uint64_t) <= bytes.size(); i += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            state = (state ^ mix(word)) * prime;
+        }
+
+        std::uint64_t tail {};
+        if (i < bytes.size())
+            std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+        return mix(state ^ tail);
+    }
+
+} // namespace sensor::codec
@@ -0,0 +1,54 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/codec/scaled.hpp
+/// @brief Defines a delta + zigzag varint encoding for columns of raw scaled sensor values.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/codec/varint.hpp>
+    #include <concepts>
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::codec
+{
+    /// @brief Appends a column of raw scaled values as zigzag varint deltas to a buffer.
+    /// @details Slowly changing sensor values produce deltas of small magnitude, which take one byte each.
+    /// @param values The values to encode.
+    /// @param output The buffer to append to.
+    template <std::integral storage_type>
+    void write_scaled(const std::span<const storage_type> values, std::vector<std::uint8_t>& output)
+    {
+        std::int64_t previous {};
+        for (const storage_type val: values)
+        {
+            const auto current = static_cast<std::int64_t>(val);
+            write_signed_varint(output, current - previous);
+            previous = current;
+        }
+    }
+
+    /// @brief Reads a number of raw scaled values written by `write_scaled` from the front of a buffer.
+    /// @param input The buffer to read from; on success it is advanced past the values.
+    /// @param count The number of values to read.
+    /// @param output The vector the values are appended to.
+    /// @return True on success, false if the buffer is truncated.
+    template <std::integral storage_type>
+    bool read_scaled(std::span<const std::uint8_t>& input, const std::size_t count, std::vector<storage_type>& output)
+    {
+        output.reserve(output.size() + count);
+        std::int64_t previous {};
+        for (std::size_t i {}; i < count; ++i)
+        {
+            const auto delta = read_signed_varint(input);
+            if (!delta)
+                return false;
+            previous += *delta;
+            output.push_back(static_cast<storage_type>(previous));
+        }
+
+        return true;
+    }
+
+} // namespace sensor::codec
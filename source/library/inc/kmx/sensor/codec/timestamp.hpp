@@ -0,0 +1,333 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/codec/timestamp.hpp
+/// @brief Defines a compressed timestamp column that stores regularly sampled stretches as
+/// (step, count) runs and irregular stretches as delta-of-delta varints, with a block directory
+/// acting as skip pointers for random access.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/codec/varint.hpp>
+    #include <kmx/sensor/data/sample.hpp>
+    #include <algorithm>
+    #include <cstddef>
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::codec
+{
+    /// @brief An immutable, compressed column of timestamps.
+    /// @details The column is split into blocks of `block_size` timestamps. The directory keeps the
+    ///          first timestamp and byte offset of every block, so any position is reached by decoding
+    ///          at most one block. A block is a sequence of tokens, each starting with the varint
+    ///          header `(count << 1) | kind`:
+    ///          - kind 0 (run): a signed varint step; the next `count` timestamps each add `step`.
+    ///          - kind 1 (jitter): `count` signed varints, each a delta-of-delta to the previous delta.
+    ///          A 1 Hz series therefore costs a few bytes per block plus one directory entry.
+    class timestamp_column
+    {
+    public:
+        /// @brief The default number of timestamps per block.
+        static constexpr std::size_t default_block_size = 1024u;
+        /// @brief The minimal number of equal consecutive deltas stored as a run.
+        static constexpr std::size_t min_run = 4u;
+
+        /// @brief Default constructor. Creates an empty column.
+        timestamp_column() noexcept = default;
+
+        /// @brief Constructor. Encodes a sequence of timestamps.
+        /// @param times The timestamps; `lower_bound` requires them to be in non-decreasing order.
+        /// @param block_size The number of timestamps per block (must be positive).
+        explicit timestamp_column(const std::span<const data::timestamp> times, const std::size_t block_size = default_block_size):
+            block_size_ {block_size}, size_ {times.size()}
+        {
+            directory_.reserve((times.size() + block_size - 1u) / block_size);
+            for (std::size_t begin {}; begin < times.size(); begin += block_size)
+            {
+                directory_.push_back(block {times[begin], data_.size()});
+                encode_block(times.subspan(begin, std::min(block_size, times.size() - begin)));
+            }
+        }
+
+        /// @brief Gets the number of timestamps in the column.
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+        /// @brief Checks whether the column is empty.
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0u; }
+
+        /// @brief Gets the number of timestamps per block.
+        [[nodiscard]] std::size_t block_size() const noexcept { return block_size_; }
+
+        /// @brief Gets the encoded token stream.
+        [[nodiscard]] std::span<const std::uint8_t> data() const noexcept { return data_; }
+
+        /// @brief Gets the encoded size in bytes, including the block directory.
+        [[nodiscard]] std::size_t bytes() const noexcept { return data_.size() + (directory_.size() * sizeof(block)); }
+
+        /// @brief Appends the column in its serialized form to a buffer.
+        /// @param output The buffer to append to.
+        void serialize(std::vector<std::uint8_t>& output) const
+        {
+            write_varint(output, size_);
+            write_varint(output, block_size_);
+            for (const block& item: directory_)
+            {
+                write_signed_varint(output, item.first);
+                write_varint(output, item.offset);
+            }
+
+            write_varint(output, data_.size());
+            output.insert(output.end(), data_.begin(), data_.end());
+        }
+
+        /// @brief Reads a column from the front of a buffer written by `serialize`.
+        /// @param input The buffer to read from; on success it is advanced past the column.
+        /// @return The column, or an empty optional if the buffer is truncated or inconsistent.
+        [[nodiscard]] static std::optional<timestamp_column> deserialize(std::span<const std::uint8_t>& input)
+        {
+            const auto size = read_varint(input);
+            const auto block_size = read_varint(input);
+            if (!size || !block_size || (*block_size == 0u))
+                return {};
+
+            timestamp_column result;
+            result.size_ = static_cast<std::size_t>(*size);
+            result.block_size_ = static_cast<std::size_t>(*block_size);
+            const std::size_t blocks = (result.size_ + result.block_size_ - 1u) / result.block_size_;
+            if (blocks > input.size())
+                return {};
+
+            result.directory_.reserve(blocks);
+            for (std::size_t i {}; i < blocks; ++i)
+            {
+                const auto first = read_signed_varint(input);
+                const auto offset = read_varint(input);
+                if (!first || !offset)
+                    return {};
+                result.directory_.push_back(block {*first, static_cast<std::size_t>(*offset)});
+            }
+
+            const auto length = read_varint(input);
+            if (!length || (*length > input.size()))
+                return {};
+            for (std::size_t previous {}; const block& item: result.directory_)
+            {
+                if ((item.offset < previous) || (item.offset > *length))
+                    return {};
+                previous = item.offset;
+            }
+
+            result.data_.assign(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(*length));
+            input = input.subspan(static_cast<std::size_t>(*length));
+            return result;
+        }
+
+        /// @brief Gets the timestamp at a position.
+        /// @return The timestamp, or an empty optional if the position is out of range.
+        [[nodiscard]] std::optional<data::timestamp> at(const std::size_t index) const noexcept
+        {
+            if (index >= size_)
+                return {};
+
+            const std::size_t block_index = index / block_size_;
+            std::size_t remaining = index % block_size_;
+            cursor state {block_input(block_index), directory_[block_index].first, 0};
+            while (remaining > 0u)
+            {
+                const auto header = read_varint(state.input);
+                if (!header)
+                    return {};
+
+                const std::size_t count = static_cast<std::size_t>(*header >> 1u);
+                if ((*header & 1u) == 0u)
+                {
+                    const auto step = read_signed_varint(state.input);
+                    if (!step)
+                        return {};
+                    const std::size_t taken = std::min(count, remaining);
+                    state.value += *step * static_cast<std::int64_t>(taken);
+                    state.delta = *step;
+                    remaining -= taken;
+                    continue;
+                }
+
+                for (std::size_t i {}; (i < count) && (remaining > 0u); ++i, --remaining)
+                    if (!state.step_jitter())
+                        return {};
+            }
+
+            return state.value;
+        }
+
+        /// @brief Decodes the whole column.
+        /// @param output The vector the timestamps are appended to.
+        /// @return True on success, false if the encoded data is corrupt.
+        bool decode(std::vector<data::timestamp>& output) const
+        {
+            output.reserve(output.size() + size_);
+            for (std::size_t block_index {}; block_index < directory_.size(); ++block_index)
+            {
+                const std::size_t count = std::min(block_size_, size_ - (block_index * block_size_));
+                cursor state {block_input(block_index), directory_[block_index].first, 0};
+                output.push_back(state.value);
+                for (std::size_t decoded = 1u; decoded < count;)
+                {
+                    const auto header = read_varint(state.input);
+                    if (!header)
+                        return false;
+
+                    const std::size_t token_count = std::min(static_cast<std::size_t>(*header >> 1u), count - decoded);
+                    if ((*header & 1u) == 0u)
+                    {
+                        const auto step = read_signed_varint(state.input);
+                        if (!step)
+                            return false;
+                        for (std::size_t i {}; i < token_count; ++i)
+                            output.push_back(state.value += *step);
+                        state.delta = *step;
+                    }
+                    else
+                    {
+                        for (std::size_t i {}; i < token_count; ++i)
+                        {
+                            if (!state.step_jitter())
+                                return false;
+                            output.push_back(state.value);
+                        }
+                    }
+
+                    decoded += token_count;
+                }
+            }
+
+            return true;
+        }
+
+        /// @brief Finds the position of the first timestamp not less than `time`.
+        /// @details Requires the column to be sorted. Runs are skipped arithmetically, so only
+        ///          jitter tokens of a single block are decoded one by one.
+        [[nodiscard]] std::size_t lower_bound(const data::timestamp time) const noexcept
+        {
+            const auto next = std::ranges::lower_bound(directory_, time, {}, &block::first);
+            const auto next_index = static_cast<std::size_t>(next - directory_.begin());
+            if (next_index == 0u)
+                return 0u;
+
+            // The answer is inside the preceding block, or it is the first position of the next one.
+            const std::size_t block_index = next_index - 1u;
+            const std::size_t block_begin = block_index * block_size_;
+            const std::size_t block_end = std::min(block_begin + block_size_, size_);
+            cursor state {block_input(block_index), directory_[block_index].first, 0};
+            std::size_t position = block_begin;
+            while (position + 1u < block_end)
+            {
+                const auto header = read_varint(state.input);
+                if (!header)
+                    break;
+
+                const std::size_t count = std::min(static_cast<std::size_t>(*header >> 1u), block_end - position - 1u);
+                if ((*header & 1u) == 0u)
+                {
+                    const auto step = read_signed_varint(state.input);
+                    if (!step)
+                        break;
+                    const data::timestamp last = state.value + (*step * static_cast<std::int64_t>(count));
+                    if ((*step > 0) && (last >= time))
+                        return position + static_cast<std::size_t>((time - state.value + *step - 1) / *step);
+
+                    state.value = last;
+                    state.delta = *step;
+                    position += count;
+                    continue;
+                }
+
+                for (std::size_t i {}; i < count; ++i)
+                {
+                    ++position;
+                    if (!state.step_jitter() || (state.value >= time))
+                        return position;
+                }
+            }
+
+            return std::min(block_end, size_);
+        }
+
+    private:
+        struct block
+        {
+            data::timestamp first;
+            std::size_t offset;
+        };
+
+        struct cursor
+        {
+            std::span<const std::uint8_t> input;
+            data::timestamp value;
+            std::int64_t delta;
+
+            /// @brief Applies the next delta-of-delta; returns false on truncated input.
+            bool step_jitter() noexcept
+            {
+                const auto delta_of_delta = read_signed_varint(input);
+                if (!delta_of_delta)
+                    return false;
+                delta += *delta_of_delta;
+                value += delta;
+                return true;
+            }
+        };
+
+        [[nodiscard]] std::span<const std::uint8_t> block_input(const std::size_t block_index) const noexcept
+        {
+            const std::size_t end = (block_index + 1u < directory_.size()) ? directory_[block_index + 1u].offset : data_.size();
+            return std::span<const std::uint8_t> {data_}.subspan(directory_[block_index].offset, end - directory_[block_index].offset);
+        }
+
+        void encode_block(const std::span<const data::timestamp> times)
+        {
+            std::vector<std::int64_t> jitter;
+            const auto flush_jitter = [this, &jitter]
+            {
+                if (jitter.empty())
+                    return;
+                write_varint(data_, (static_cast<std::uint64_t>(jitter.size()) << 1u) | 1u);
+                for (const std::int64_t delta_of_delta: jitter)
+                    write_signed_varint(data_, delta_of_delta);
+                jitter.clear();
+            };
+
+            std::int64_t previous_delta {};
+            for (std::size_t i = 1u; i < times.size();)
+            {
+                const std::int64_t delta = times[i] - times[i - 1u];
+                std::size_t run = 1u;
+                while ((i + run < times.size()) && (times[i + run] - times[i + run - 1u] == delta))
+                    ++run;
+
+                if (run >= min_run)
+                {
+                    flush_jitter();
+                    write_varint(data_, static_cast<std::uint64_t>(run) << 1u);
+                    write_signed_varint(data_, delta);
+                    i += run;
+                }
+                else
+                {
+                    jitter.push_back(delta - previous_delta);
+                    ++i;
+                }
+
+                previous_delta = delta;
+            }
+
+            flush_jitter();
+        }
+
+        std::size_t block_size_ = default_block_size;
+        std::size_t size_ {};
+        std::vector<block> directory_;
+        std::vector<std::uint8_t> data_;
+    };
+
+} // namespace sensor::codec
@@ -0,0 +1,72 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/codec/varint.hpp
+/// @brief Defines zigzag mapping and LEB128 variable-length integer encoding helpers.
+#pragma once
+#ifndef PCH
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::codec
+{
+    /// @brief Maps a signed integer to an unsigned one so that values of small magnitude stay small.
+    [[nodiscard]] constexpr std::uint64_t zigzag_encode(const std::int64_t val) noexcept
+    {
+        return (static_cast<std::uint64_t>(val) << 1u) ^ static_cast<std::uint64_t>(val >> 63);
+    }
+
+    /// @brief Inverse of `zigzag_encode`.
+    [[nodiscard]] constexpr std::int64_t zigzag_decode(const std::uint64_t val) noexcept
+    {
+        return static_cast<std::int64_t>(val >> 1u) ^ -static_cast<std::int64_t>(val & 1u);
+    }
+
+    /// @brief Appends an unsigned integer as a LEB128 varint (7 bits per byte, low bits first).
+    /// @param output The buffer to append to.
+    /// @param val The value to encode.
+    inline void write_varint(std::vector<std::uint8_t>& output, std::uint64_t val)
+    {
+        while (val >= 0x80u)
+        {
+            output.push_back(static_cast<std::uint8_t>(val | 0x80u));
+            val >>= 7u;
+        }
+
+        output.push_back(static_cast<std::uint8_t>(val));
+    }
+
+    /// @brief Appends a signed integer as a zigzag LEB128 varint.
+    inline void write_signed_varint(std::vector<std::uint8_t>& output, const std::int64_t val) { write_varint(output, zigzag_encode(val)); }
+
+    /// @brief Reads a LEB128 varint from the front of a buffer and advances the buffer past it.
+    /// @param input The buffer to read from; on success it is shortened by the bytes consumed.
+    /// @return The decoded value, or an empty optional if the buffer is truncated or the varint is too long.
+    [[nodiscard]] constexpr std::optional<std::uint64_t> read_varint(std::span<const std::uint8_t>& input) noexcept
+    {
+        std::uint64_t result {};
+        for (std::size_t i {}; (i < input.size()) && (i < 10u); ++i)
+        {
+            const std::uint8_t byte = input[i];
+            result |= static_cast<std::uint64_t>(byte & 0x7Fu) << (7u * i);
+            if ((byte & 0x80u) == 0u)
+            {
+                input = input.subspan(i + 1u);
+                return result;
+            }
+        }
+
+        return {};
+    }
+
+    /// @brief Reads a zigzag LEB128 varint from the front of a buffer and advances the buffer past it.
+    [[nodiscard]] constexpr std::optional<std::int64_t> read_signed_varint(std::span<const std::uint8_t>& input) noexcept
+    {
+        const auto val = read_varint(input);
+        if (!val)
+            return {};
+        return zigzag_decode(*val);
+    }
+
+} // namespace sensor::codec
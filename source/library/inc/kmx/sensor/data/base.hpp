@@ -5,6 +5,7 @@
 /// configuration via sensor_traits, with optional storage.
 #pragma once
 #ifndef PCH
+    #include <kmx/sensor/data/half.hpp>
     #include <algorithm>
     #include <array>
     #include <cmath>
@@ -13,7 +14,9 @@
     #include <cstdint>
     #include <limits>
     #include <optional>
+    #include <span>
     #include <string_view>
+    #include <type_traits>
 #endif
 
 namespace kmx
@@ -59,20 +62,81 @@ namespace kmx
 
 namespace kmx::sensor::data
 {
+    /// @brief Satisfied by the types a sensor value can be stored in: integers holding the value scaled by
+    ///        1 / resolution, or 16-bit floating-point types holding the physical value itself.
+    template <typename type>
+    concept storage_value = std::integral<type> || half_precision<type>;
+
+    /// @brief Satisfied by sensor traits whose values are stored as integers scaled by 1 / resolution.
+    /// @details Code doing integer arithmetic on raw values (sums, stepping bounds by one, delta codecs)
+    ///          requires it; 16-bit floating-point storage holds physical values and would yield wrong results.
+    template <typename traits>
+    concept integer_scaled = std::integral<typename traits::storage_type>;
+
+    /// @brief How physical values are rounded to integer scaled values.
+    enum class rounding_mode : std::uint8_t
+    {
+        half_away,    ///< To nearest, ties away from zero (like std::round); the default.
+        nearest_even, ///< To nearest, ties to even (like std::nearbyint in the default environment).
+        truncate,     ///< Toward zero.
+        floor,        ///< Toward negative infinity.
+    };
+
+    /// @brief Rounds a scaled floating-point value to an integer storage type.
+    /// @details Works on a truncating conversion and the remainder it leaves, which is exact, and selects the
+    ///          correction without branches or library calls. Scalar conversions and batch loops therefore use
+    ///          the same code and give bit-identical results, and the loops vectorize (a truncating conversion
+    ///          per lane plus compares). The value must lie within the range of `storage_type`.
+    /// @tparam mode The rounding mode.
+    /// @tparam storage_type The integer storage type.
+    /// @param val The scaled value.
+    /// @return The rounded value.
+    template <rounding_mode mode, std::integral storage_type, std::floating_point input_type>
+    [[nodiscard]] constexpr storage_type round_scaled(const input_type val) noexcept
+    {
+        // Unsigned 32-bit and all 64-bit values need a 64-bit conversion; everything else fits 32 bits.
+        constexpr bool narrow = (sizeof(storage_type) < 4u) || (std::is_signed_v<storage_type> && (sizeof(storage_type) == 4u));
+        using wide_type = std::conditional_t<narrow, std::int32_t, std::int64_t>;
+        const auto whole = static_cast<wide_type>(val);
+        if constexpr (mode == rounding_mode::truncate)
+            return static_cast<storage_type>(whole);
+        else
+        {
+            const input_type remainder = val - static_cast<input_type>(whole);
+            constexpr auto half = static_cast<input_type>(0.5);
+            if constexpr (mode == rounding_mode::floor)
+                return static_cast<storage_type>(whole - wide_type {remainder < 0});
+            else if constexpr (mode == rounding_mode::half_away)
+                return static_cast<storage_type>(whole + wide_type {remainder >= half} - wide_type {remainder <= -half});
+            else
+            {
+                const wide_type odd = whole & 1;
+                const wide_type up = wide_type {remainder > half} | (wide_type {remainder == half} & odd);
+                const wide_type down = wide_type {remainder < -half} | (wide_type {remainder == -half} & odd);
+                return static_cast<storage_type>(whole + up - down);
+            }
+        }
+    }
+
     /// @brief A template struct to define the characteristics of a sensor type.
     /// @details This struct is used as a template parameter for the `sensor::data::base` class
     ///          to provide compile-time configuration for sensor properties such as storage type,
     ///          input type, valid range, resolution, and unit.
-    /// @tparam _Storage The underlying integer type used to store the scaled sensor value (e.g., std::int16_t).
-    ///           Must satisfy `std::integral`.
+    /// @tparam _Storage The underlying type used to store the sensor value. An integer type (e.g., std::int16_t)
+    ///           stores the value scaled by 1 / resolution. A 16-bit floating-point type (`float16` or
+    ///           `bfloat16`) stores the physical value rounded to its precision, for sensors whose range and
+    ///           resolution do not fit a small integer or that need relative rather than absolute precision;
+    ///           the resolution then only documents the nominal precision. Must satisfy `storage_value`.
     /// @tparam _Input The floating-point type used for the physical sensor value (e.g., float, double).
     ///           Must satisfy `std::floating_point`.
     /// @tparam param_min_value The minimum representable physical value for the sensor.
     /// @tparam param_max_value The maximum representable physical value for the sensor.
     /// @tparam param_resolution The resolution (smallest representable change) of the physical sensor value.
     /// @tparam param_unit The physical unit of the sensor's value, from the `unit` enum.
-    template <std::integral _Storage, std::floating_point _Input, _Input param_min_value, _Input param_max_value, _Input param_resolution,
-              kmx::unit param_unit>
+    /// @tparam param_rounding How physical values are rounded to integer scaled values; pipelines that do not
+    ///           depend on the tie rule can choose `rounding_mode::nearest_even` or `truncate`.
+    template <storage_value _Storage, std::floating_point _Input, _Input param_min_value, _Input param_max_value, _Input param_resolution,
+              kmx::unit param_unit, rounding_mode param_rounding = rounding_mode::half_away>
     struct traits
     {
         /// @brief The underlying integer type for storing the scaled sensor value.
@@ -90,6 +154,8 @@ namespace kmx::sensor::data
         static constexpr input_type resolution = param_resolution;
         /// @brief The physical unit of the sensor's value.
         static constexpr unit_type unit = param_unit;
+        /// @brief The rounding of physical values to integer scaled values.
+        static constexpr rounding_mode rounding = param_rounding;
 
         // Compile-time assertions for trait validity
         static_assert(resolution > static_cast<input_type>(0.0), "Resolution must be positive.");
@@ -175,7 +241,8 @@ namespace kmx::sensor::data
         ///         If false, the sensor's defined state remains unchanged.
         [[nodiscard]] constexpr bool set_raw_scaled_value(const storage_type raw_val) noexcept
         {
-            if ((raw_val < static_min_scaled_value) || (raw_val > static_max_scaled_value))
+            // Written positively so that a NaN of a 16-bit floating-point storage type is rejected, as in the constructor.
+            if (!((raw_val >= static_min_scaled_value) && (raw_val <= static_max_scaled_value)))
                 return false;
 
             scaled_value_ = raw_val;
@@ -211,29 +278,107 @@ namespace kmx::sensor::data
         /// @brief Gets the maximum storable scaled integer value.
         [[nodiscard]] static constexpr storage_type max_scaled_storage_value() noexcept { return static_max_scaled_value; }
 
+        /// @brief Converts a physical value to its scaled integer representation.
+        ///        The value is clamped to the sensor's valid range before it is quantized.
+        /// @param val The physical value to convert.
+        /// @return The corresponding scaled integer value.
+        [[nodiscard]] static constexpr storage_type to_scaled(const input_type val) noexcept
+        {
+            return convert_to_scaled(std::clamp(val, traits_type::min_value, traits_type::max_value));
+        }
+
+        /// @brief Converts a scaled integer value to its physical representation.
+        /// @param val The scaled integer value.
+        /// @return The corresponding physical value.
+        [[nodiscard]] static constexpr input_type to_physical(const storage_type val) noexcept { return convert_to_physical(val); }
+
+        /// @brief Converts physical values to scaled values in bulk.
+        /// @details Gives exactly the results of the scalar `to_scaled()`, in a loop without branches that
+        ///          compilers vectorize.
+        /// @param values The physical values; each is clamped to the valid range.
+        /// @param output The scaled values; only the common length is converted.
+        static constexpr void to_scaled(const std::span<const input_type> values, const std::span<storage_type> output) noexcept
+        {
+            const std::size_t count = std::min(values.size(), output.size());
+            if constexpr (half_precision<storage_type>)
+            {
+                for (std::size_t i {}; i < count; ++i)
+                    output[i] = to_scaled(values[i]);
+            }
+            else
+            {
+                // Clamping after scaling gives the same results, as scaling by a positive factor is monotonic.
+                // The values are clamped and rounded in two passes over a small block: in one loop, GCC
+                // specializes the rounding for the clamped bounds and then cannot if-convert it.
+                constexpr input_type low = traits_type::min_value * scale_factor;
+                constexpr input_type high = traits_type::max_value * scale_factor;
+                constexpr std::size_t block = 256u;
+                std::array<input_type, block> staged {};
+                for (std::size_t first {}; first < count; first += block)
+                {
+                    const std::size_t size = std::min(block, count - first);
+                    for (std::size_t i {}; i < size; ++i)
+                    {
+                        input_type scaled_float = values[first + i] * scale_factor;
+                        scaled_float = (scaled_float < low) ? low : scaled_float;
+                        staged[i] = (high < scaled_float) ? high : scaled_float;
+                    }
+                    for (std::size_t i {}; i < size; ++i)
+                        output[first + i] = round_scaled<traits_type::rounding, storage_type>(staged[i]);
+                }
+            }
+        }
+
+        /// @brief Converts scaled values to physical values in bulk.
+        /// @param values The scaled values.
+        /// @param output The physical values; only the common length is converted.
+        static constexpr void to_physical(const std::span<const storage_type> values, const std::span<input_type> output) noexcept
+        {
+            const std::size_t count = std::min(values.size(), output.size());
+            for (std::size_t i {}; i < count; ++i)
+                output[i] = convert_to_physical(values[i]);
+        }
+
     protected:
         /// @brief Converts a physical value (which should already be clamped) to its scaled integer representation.
         /// @details This static constexpr method performs the scaling by multiplying with `scale_factor`,
-        ///          rounds the result to the nearest integer, and then casts it to `storage_type`.
+        ///          rounds the result to an integer as selected by `traits_type::rounding` (to nearest, ties
+        ///          away from zero by default), and then casts it to `storage_type`.
         ///          It assumes the input `val` is already within the sensor's valid physical range
         ///          (i.e., between `traits_type::min_value` and `traits_type::max_value`).
+        ///          A 16-bit floating-point `storage_type` keeps the physical value instead, rounded to nearest even;
+        ///          `bfloat16` converts from float only, so a double `input_type` is rounded twice for it (to float,
+        ///          then to bfloat16), which can differ from a single rounding in the last bit on exact ties.
         /// @param val The physical value to convert (must be pre-clamped).
         /// @return The corresponding scaled integer value.
         [[nodiscard]] static constexpr storage_type convert_to_scaled(const input_type val) noexcept
         {
-            const input_type scaled_float = val * scale_factor;
-            return static_cast<storage_type>(std::round(scaled_float));
+            if constexpr (std::same_as<storage_type, bfloat16>)
+                return storage_type {static_cast<float>(val)};
+            else if constexpr (half_precision<storage_type>)
+                return static_cast<storage_type>(val);
+            else
+            {
+                const input_type scaled_float = val * scale_factor;
+                return round_scaled<traits_type::rounding, storage_type>(scaled_float);
+            }
         }
 
         /// @brief Converts a scaled integer value back to its physical floating-point representation.
         /// @details This static constexpr method performs the conversion by casting the scaled `val`
         ///          to `input_type` and then dividing by `scale_factor`.
+        ///          A 16-bit floating-point `storage_type` already holds the physical value and is only widened.
         /// @param val The scaled integer value.
         /// @return The corresponding physical value.
         [[nodiscard]] static constexpr input_type convert_to_physical(const storage_type val) noexcept
         {
-            const auto scaled_val_as_input = static_cast<input_type>(val);
-            return scaled_val_as_input / scale_factor;
+            if constexpr (half_precision<storage_type>)
+                return static_cast<input_type>(static_cast<float>(val));
+            else
+            {
+                const auto scaled_val_as_input = static_cast<input_type>(val);
+                return scaled_val_as_input / scale_factor;
+            }
         }
 
         /// @brief The numerator used in calculating the scaling factor. Typically 1.0.
@@ -0,0 +1,344 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/data/dynamic.hpp
+/// @brief Defines a sensor type descriptor configured at run time (e.g. from a device model file) with
+/// batch conversion kernels that are selected once per batch by storage width.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/base.hpp>
+    #include <algorithm>
+    #include <array>
+    #include <cmath>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <limits>
+    #include <optional>
+    #include <span>
+    #include <type_traits>
+#endif
+
+namespace kmx::sensor::data
+{
+    /// @brief The integer type a run-time defined sensor stores its scaled values in.
+    enum class storage_width : std::uint8_t
+    {
+        int8,
+        uint8,
+        int16,
+        uint16,
+        int32,
+        uint32,
+    };
+
+    /// @brief Gets the storage width of an integer type.
+    template <std::integral storage_type>
+    [[nodiscard]] constexpr storage_width width_of() noexcept
+    {
+        static_assert(sizeof(storage_type) <= 4u, "Storage types wider than 32 bits are not supported.");
+        if constexpr (sizeof(storage_type) == 1u)
+            return std::is_signed_v<storage_type> ? storage_width::int8 : storage_width::uint8;
+        else if constexpr (sizeof(storage_type) == 2u)
+            return std::is_signed_v<storage_type> ? storage_width::int16 : storage_width::uint16;
+        else
+            return std::is_signed_v<storage_type> ? storage_width::int32 : storage_width::uint32;
+    }
+
+    /// @brief Gets the number of bytes of one value of a storage width.
+    [[nodiscard]] constexpr std::size_t bytes_of(const storage_width width) noexcept
+    {
+        return std::size_t {1u} << (static_cast<unsigned>(width) / 2u);
+    }
+
+    /// @brief The description of a sensor type known only at run time.
+    /// @details Holds the same properties as `traits<...>` and converts values exactly like `base<traits>`
+    ///          does: physical values are clamped, multiplied by the precomputed 1 / resolution and rounded
+    ///          with `round_scaled()` in the configured rounding mode. Scaled values are converted back by multiplying with the resolution
+    ///          (derived from the same factor) instead of dividing, which may differ from `base::to_physical`
+    ///          in the last bit. The batch functions switch on the storage width and rounding once and then run a plain
+    ///          loop that compilers vectorize, so a configured sensor type converts at the speed of a
+    ///          compiled one.
+    class dynamic_sensor
+    {
+    public:
+        using input_type = float;
+
+        /// @brief Creates a descriptor, validating the configuration.
+        /// @param width The storage width of scaled values.
+        /// @param min_value The minimum physical value.
+        /// @param max_value The maximum physical value.
+        /// @param resolution The smallest representable change of the physical value.
+        /// @param unit The physical unit.
+        /// @param rounding How physical values are rounded to scaled values.
+        /// @return The descriptor, or an empty optional if the resolution is not positive, the range is empty
+        ///         or its scaled bounds do not fit the storage width.
+        [[nodiscard]] static std::optional<dynamic_sensor> make(const storage_width width, const input_type min_value,
+                                                                const input_type max_value, const input_type resolution,
+                                                                const kmx::unit unit,
+                                                                const rounding_mode rounding = rounding_mode::half_away) noexcept
+        {
+            if (!(resolution > 0.0f) || !(min_value <= max_value) || !std::isfinite(min_value) || !std::isfinite(max_value))
+                return {};
+
+            const input_type scale = 1.0f / resolution;
+            // Scaled bounds beyond any storage width would overflow the 64-bit rounding below.
+            constexpr input_type limit = 0x1p62f;
+            if (!(std::fabs(min_value * scale) < limit) || !(std::fabs(max_value * scale) < limit))
+                return {};
+
+            // The bounds the constructor stores, rounded the same way.
+            const std::int64_t low = round(rounding, min_value * scale);
+            const std::int64_t high = round(rounding, max_value * scale);
+            const bool fits = dispatch(width,
+                                       [&]<typename storage_type>(std::type_identity<storage_type>)
+                                       {
+                                           using limits = std::numeric_limits<storage_type>;
+                                           return (static_cast<double>(low) >= static_cast<double>(limits::min())) &&
+                                                  (static_cast<double>(high) <= static_cast<double>(limits::max()));
+                                       });
+            if (!fits)
+                return {};
+
+            return dynamic_sensor {width, min_value, max_value, resolution, unit, rounding};
+        }
+
+        /// @brief Creates the descriptor of a compile-time sensor type.
+        template <typename traits>
+        [[nodiscard]] static dynamic_sensor of() noexcept
+        {
+            static_assert(std::is_same_v<typename traits::input_type, input_type>, "Only float physical values are supported.");
+            return dynamic_sensor {width_of<typename traits::storage_type>(),
+                                   traits::min_value,
+                                   traits::max_value,
+                                   traits::resolution,
+                                   traits::unit,
+                                   traits::rounding};
+        }
+
+        /// @brief Gets the storage width of scaled values.
+        [[nodiscard]] storage_width width() const noexcept { return width_; }
+
+        /// @brief Gets the number of bytes of one scaled value.
+        [[nodiscard]] std::size_t value_bytes() const noexcept { return bytes_of(width_); }
+
+        /// @brief Gets the minimum physical value.
+        [[nodiscard]] input_type min_value() const noexcept { return min_value_; }
+
+        /// @brief Gets the maximum physical value.
+        [[nodiscard]] input_type max_value() const noexcept { return max_value_; }
+
+        /// @brief Gets the resolution of the physical value.
+        [[nodiscard]] input_type resolution() const noexcept { return resolution_; }
+
+        /// @brief Gets the physical unit.
+        [[nodiscard]] kmx::unit unit() const noexcept { return unit_; }
+
+        /// @brief Gets the rounding of physical values to scaled values.
+        [[nodiscard]] rounding_mode rounding() const noexcept { return rounding_; }
+
+        /// @brief Gets the minimum valid scaled value.
+        [[nodiscard]] std::int64_t min_scaled_storage_value() const noexcept { return min_scaled_; }
+
+        /// @brief Gets the maximum valid scaled value.
+        [[nodiscard]] std::int64_t max_scaled_storage_value() const noexcept { return max_scaled_; }
+
+        /// @brief Checks whether a scaled value lies within the valid range.
+        [[nodiscard]] bool valid(const std::int64_t val) const noexcept { return (val >= min_scaled_) && (val <= max_scaled_); }
+
+        /// @brief Converts a physical value to its scaled representation, clamping it to the valid range.
+        [[nodiscard]] std::int64_t to_scaled(const input_type val) const noexcept
+        {
+            return round(rounding_, std::clamp(val, min_value_, max_value_) * scale_);
+        }
+
+        /// @brief Converts a scaled value to its physical representation.
+        [[nodiscard]] input_type to_physical(const std::int64_t val) const noexcept { return static_cast<input_type>(val) * step_; }
+
+        /// @brief Converts physical values to scaled values of the descriptor's storage type.
+        /// @param values The physical values; each is clamped to the valid range.
+        /// @param raw The scaled values as packed bytes in native byte order, `value_bytes()` per value.
+        /// @return The number of converted values, limited by the room in `raw`.
+        std::size_t to_scaled(const std::span<const input_type> values, const std::span<std::byte> raw) const noexcept
+        {
+            const std::size_t count = std::min(values.size(), raw.size() / value_bytes());
+            dispatch(width_,
+                     [&]<typename storage_type>(std::type_identity<storage_type>)
+                     {
+                         std::array<storage_type, block> staged;
+                         for (std::size_t first {}; first < count; first += block)
+                         {
+                             const std::size_t size = std::min(block, count - first);
+                             scale_values(values.data() + first, staged.data(), size);
+                             std::memcpy(raw.data() + (first * sizeof(storage_type)), staged.data(), size * sizeof(storage_type));
+                         }
+                         return true;
+                     });
+            return count;
+        }
+
+        /// @brief Converts scaled values of the descriptor's storage type to physical values.
+        /// @param raw The scaled values as packed bytes in native byte order, `value_bytes()` per value.
+        /// @param values The physical values; scaled values outside the valid range become quiet NaN.
+        /// @return The number of converted values, limited by the room in `values`.
+        std::size_t to_physical(const std::span<const std::byte> raw, const std::span<input_type> values) const noexcept
+        {
+            const std::size_t count = std::min(values.size(), raw.size() / value_bytes());
+            dispatch(width_,
+                     [&]<typename storage_type>(std::type_identity<storage_type>)
+                     {
+                         std::array<storage_type, block> staged;
+                         for (std::size_t first {}; first < count; first += block)
+                         {
+                             const std::size_t size = std::min(block, count - first);
+                             std::memcpy(staged.data(), raw.data() + (first * sizeof(storage_type)), size * sizeof(storage_type));
+                             unscale_values(staged.data(), values.data() + first, size, min_scaled_, max_scaled_, step_);
+                         }
+                         return true;
+                     });
+            return count;
+        }
+
+        /// @brief Converts physical values to scaled values held in a typed span.
+        /// @return False if `storage_type` does not match the descriptor's storage width, true otherwise.
+        template <std::integral storage_type>
+        bool to_scaled(const std::span<const input_type> values, const std::span<storage_type> raw) const noexcept
+        {
+            if (width_of<storage_type>() != width_)
+                return false;
+
+            scale_values(values.data(), raw.data(), std::min(values.size(), raw.size()));
+            return true;
+        }
+
+        /// @brief Converts scaled values held in a typed span to physical values.
+        /// @return False if `storage_type` does not match the descriptor's storage width, true otherwise.
+        template <std::integral storage_type>
+        bool to_physical(const std::span<const storage_type> raw, const std::span<input_type> values) const noexcept
+        {
+            if (width_of<storage_type>() != width_)
+                return false;
+
+            unscale_values(raw.data(), values.data(), std::min(values.size(), raw.size()), min_scaled_, max_scaled_, step_);
+            return true;
+        }
+
+    private:
+        dynamic_sensor(const storage_width width, const input_type min_value, const input_type max_value, const input_type resolution,
+                       const kmx::unit unit, const rounding_mode rounding) noexcept:
+            width_ {width},
+            unit_ {unit},
+            rounding_ {rounding},
+            min_value_ {min_value},
+            max_value_ {max_value},
+            resolution_ {resolution},
+            scale_ {1.0f / resolution},
+            step_ {1.0f / scale_},
+            min_scaled_ {round(rounding, min_value * scale_)},
+            max_scaled_ {round(rounding, max_value * scale_)}
+        {
+        }
+
+        // The number of values the byte-level functions stage in a typed buffer at a time.
+        static constexpr std::size_t block = 256u;
+
+        // Rounds one scaled value in a rounding mode chosen at run time.
+        [[nodiscard]] static std::int64_t round(const rounding_mode mode, const input_type val) noexcept
+        {
+            switch (mode)
+            {
+                case rounding_mode::nearest_even:
+                    return round_scaled<rounding_mode::nearest_even, std::int64_t>(val);
+                case rounding_mode::truncate:
+                    return round_scaled<rounding_mode::truncate, std::int64_t>(val);
+                case rounding_mode::floor:
+                    return round_scaled<rounding_mode::floor, std::int64_t>(val);
+                default:
+                    return round_scaled<rounding_mode::half_away, std::int64_t>(val);
+            }
+        }
+
+        // The kernels work on typed arrays and take everything they read by value, so that stores cannot
+        // alias the descriptor and the loops have no control flow left after if-conversion.
+        template <rounding_mode mode, typename storage_type>
+        static void scale_values(const input_type* const values, storage_type* const output, const std::size_t count,
+                                 const input_type low, const input_type high, const input_type scale) noexcept
+        {
+            for (std::size_t i {}; i < count; ++i)
+            {
+                input_type val = values[i];
+                val = (val < low) ? low : val;
+                val = (val > high) ? high : val;
+                output[i] = round_scaled<mode, storage_type>(val * scale);
+            }
+        }
+
+        template <typename storage_type>
+        void scale_values(const input_type* const values, storage_type* const output, const std::size_t count) const noexcept
+        {
+            switch (rounding_)
+            {
+                case rounding_mode::nearest_even:
+                    scale_values<rounding_mode::nearest_even>(values, output, count, min_value_, max_value_, scale_);
+                    break;
+                case rounding_mode::truncate:
+                    scale_values<rounding_mode::truncate>(values, output, count, min_value_, max_value_, scale_);
+                    break;
+                case rounding_mode::floor:
+                    scale_values<rounding_mode::floor>(values, output, count, min_value_, max_value_, scale_);
+                    break;
+                default:
+                    scale_values<rounding_mode::half_away>(values, output, count, min_value_, max_value_, scale_);
+                    break;
+            }
+        }
+
+        template <typename storage_type>
+        static void unscale_values(const storage_type* const input, input_type* const values, const std::size_t count,
+                                   const std::int64_t min_scaled, const std::int64_t max_scaled, const input_type step) noexcept
+        {
+            const auto low = static_cast<storage_type>(min_scaled);
+            const auto high = static_cast<storage_type>(max_scaled);
+            constexpr input_type undefined = std::numeric_limits<input_type>::quiet_NaN();
+            for (std::size_t i {}; i < count; ++i)
+            {
+                const storage_type val = input[i];
+                const bool inside = (val >= low) & (val <= high);
+                values[i] = inside ? static_cast<input_type>(val) * step : undefined;
+            }
+        }
+
+        // Calls `function` with the integer type of a storage width.
+        template <typename function>
+        static bool dispatch(const storage_width width, function&& call) noexcept
+        {
+            switch (width)
+            {
+                case storage_width::int8:
+                    return call(std::type_identity<std::int8_t> {});
+                case storage_width::uint8:
+                    return call(std::type_identity<std::uint8_t> {});
+                case storage_width::int16:
+                    return call(std::type_identity<std::int16_t> {});
+                case storage_width::uint16:
+                    return call(std::type_identity<std::uint16_t> {});
+                case storage_width::int32:
+                    return call(std::type_identity<std::int32_t> {});
+                case storage_width::uint32:
+                    return call(std::type_identity<std::uint32_t> {});
+            }
+
+            return false;
+        }
+
+        storage_width width_;
+        kmx::unit unit_;
+        rounding_mode rounding_;
+        input_type min_value_;
+        input_type max_value_;
+        input_type resolution_;
+        input_type scale_;
+        input_type step_;
+        std::int64_t min_scaled_;
+        std::int64_t max_scaled_;
+    };
+
+} // namespace sensor::data
@@ -0,0 +1,124 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/data/half.hpp
+/// @brief Defines 16-bit floating-point storage types (IEEE binary16 and bfloat16) for sensors whose
+/// values are kept as physical values rather than scaled integers, with batch conversions from and to float.
+#pragma once
+#ifndef PCH
+    #include <algorithm>
+    #include <bit>
+    #include <compare>
+    #include <concepts>
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #if defined(__F16C__)
+        #include <immintrin.h>
+    #endif
+#endif
+
+namespace kmx::sensor::data
+{
+#if defined(__FLT16_MANT_DIG__)
+    /// @brief IEEE 754 binary16: 11 significant bits over ±65504; suits bounded ranges needing fine steps.
+    using float16 = _Float16;
+#endif
+
+    /// @brief The upper half of an IEEE 754 binary32: 8 significant bits over the whole float range.
+    /// @details Suits sensors whose range spans many orders of magnitude (e.g. illuminance, gas
+    ///          concentrations) and whose readings need a relative rather than an absolute precision.
+    class bfloat16
+    {
+    public:
+        /// @brief Default constructor; the value is +0.
+        constexpr bfloat16() noexcept = default;
+
+        /// @brief Constructor, rounding to the nearest representable value with ties to even.
+        constexpr explicit bfloat16(const float val) noexcept: bits_ {narrow_bits(std::bit_cast<std::uint32_t>(val))} {}
+
+        /// @brief Gets the value as a float; the conversion is exact.
+        [[nodiscard]] constexpr explicit operator float() const noexcept { return std::bit_cast<float>(std::uint32_t {bits_} << 16u); }
+
+        /// @brief Creates a value from its bit pattern.
+        [[nodiscard]] static constexpr bfloat16 from_bits(const std::uint16_t bits) noexcept
+        {
+            bfloat16 result;
+            result.bits_ = bits;
+            return result;
+        }
+
+        /// @brief Gets the bit pattern of the value.
+        [[nodiscard]] constexpr std::uint16_t bits() const noexcept { return bits_; }
+
+        [[nodiscard]] friend constexpr bool operator==(const bfloat16 lhs, const bfloat16 rhs) noexcept
+        {
+            return static_cast<float>(lhs) == static_cast<float>(rhs);
+        }
+
+        [[nodiscard]] friend constexpr std::partial_ordering operator<=>(const bfloat16 lhs, const bfloat16 rhs) noexcept
+        {
+            return static_cast<float>(lhs) <=> static_cast<float>(rhs);
+        }
+
+        /// @brief Rounds the bit pattern of a float to that of a bfloat16; NaNs stay (quiet) NaNs.
+        /// @details Branch-free, so that loops over it vectorize.
+        [[nodiscard]] static constexpr std::uint16_t narrow_bits(const std::uint32_t bits) noexcept
+        {
+            const std::uint32_t rounded = (bits + 0x7FFFu + ((bits >> 16u) & 1u)) >> 16u;
+            const std::uint32_t quiet = (bits >> 16u) | 0x0040u;
+            return static_cast<std::uint16_t>(((bits & 0x7FFFFFFFu) > 0x7F800000u) ? quiet : rounded);
+        }
+
+    private:
+        std::uint16_t bits_ {};
+    };
+
+    /// @brief Satisfied by the 16-bit floating-point storage types.
+    template <typename type>
+    concept half_precision = std::same_as<type, bfloat16>
+#if defined(__FLT16_MANT_DIG__)
+                             || std::same_as<type, float16>
+#endif
+        ;
+
+    /// @brief Converts floats to a 16-bit floating-point type, rounding to nearest with ties to even.
+    /// @details binary16 uses the F16C conversion instruction eight values at a time where available.
+    /// @param input The values.
+    /// @param output The converted values; only the common length is converted.
+    template <half_precision half_type>
+    void narrow(const std::span<const float> input, const std::span<half_type> output) noexcept
+    {
+        const std::size_t count = std::min(input.size(), output.size());
+        std::size_t i {};
+#if defined(__F16C__)
+        if constexpr (!std::same_as<half_type, bfloat16>)
+            for (; i + 8u <= count; i += 8u)
+            {
+                const __m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(input.data() + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + i), packed);
+            }
+#endif
+        for (; i < count; ++i)
+            output[i] = static_cast<half_type>(input[i]);
+    }
+
+    /// @brief Converts values of a 16-bit floating-point type to floats; the conversion is exact.
+    /// @param input The values.
+    /// @param output The converted values; only the common length is converted.
+    template <half_precision half_type>
+    void widen(const std::span<const half_type> input, const std::span<float> output) noexcept
+    {
+        const std::size_t count = std::min(input.size(), output.size());
+        std::size_t i {};
+#if defined(__F16C__)
+        if constexpr (!std::same_as<half_type, bfloat16>)
+            for (; i + 8u <= count; i += 8u)
+            {
+                const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i));
+                _mm256_storeu_ps(output.data() + i, _mm256_cvtph_ps(packed));
+            }
+#endif
+        for (; i < count; ++i)
+            output[i] = static_cast<float>(input[i]);
+    }
+
+} // namespace sensor::data
@@ -0,0 +1,225 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/data/pool.hpp
+/// @brief Defines a pool of per-sensor operator state (filters, windows, deadbands, alert state)
+/// kept as packed structure-of-arrays columns and addressed by generational handles.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <cstddef>
+    #include <cstdint>
+    #include <limits>
+    #include <span>
+    #include <tuple>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::data
+{
+    /// @brief A reference to the state of one sensor in a `state_pool`.
+    /// @details The generation tells apart successive lifetimes of the same sensor id, so a handle kept
+    ///          by e.g. an alert rule is detected as stale once the sensor is destroyed and created again.
+    struct handle
+    {
+        /// @brief The sensor id the state belongs to.
+        sensor_id index = std::numeric_limits<sensor_id>::max();
+        /// @brief The lifetime of the sensor id the handle was issued for.
+        std::uint32_t generation {};
+
+        [[nodiscard]] constexpr bool operator==(const handle&) const noexcept = default;
+    };
+
+    /// @brief Keeps one set of state fields for each live sensor, with every field in its own packed array.
+    /// @details Live entries occupy positions [0, size()) of each column in no particular order; destroying
+    ///          an entry moves the last one into its place, so the columns never contain holes and a sweep
+    ///          over all sensors is a linear scan of exactly the fields it touches. Two small arrays indexed
+    ///          by sensor id hold the generation and the column position of each id, so creating,
+    ///          destroying and resolving a handle are O(1). Positions change on `destroy()`; keep handles or
+    ///          sensor ids, not positions. The pool is not thread-safe.
+    /// @tparam fields The state field types, e.g. `float` filter state, `timestamp` window starts.
+    template <typename... fields>
+    class state_pool
+    {
+    public:
+        static_assert(sizeof...(fields) > 0u, "A state pool needs at least one field.");
+
+        /// @brief Constructor.
+        /// @param sensors The expected number of sensor ids, [0, sensors); larger ids grow the pool.
+        explicit state_pool(const std::size_t sensors = 0u): generations_(sensors), positions_(sensors, none) {}
+
+        /// @brief Creates the state of a sensor from initial field values.
+        /// @param sensor The sensor id.
+        /// @param initial The initial value of each field.
+        /// @return The handle of the new state, or the current handle if the sensor already has state
+        ///         (which is then left unchanged).
+        handle create(const sensor_id sensor, fields... initial)
+        {
+            if (sensor == none)
+                return {};
+
+            if (sensor >= positions_.size())
+            {
+                generations_.resize(static_cast<std::size_t>(sensor) + 1u);
+                positions_.resize(static_cast<std::size_t>(sensor) + 1u, none);
+            }
+
+            if (positions_[sensor] == none)
+            {
+                positions_[sensor] = static_cast<std::uint32_t>(sensors_.size());
+                sensors_.push_back(sensor);
+                [&]<std::size_t... i>(std::index_sequence<i...>)
+                { (std::get<i>(columns_).push_back(std::move(initial)), ...); }(std::index_sequence_for<fields...> {});
+            }
+
+            return handle {sensor, generations_[sensor]};
+        }
+
+        /// @brief Destroys the state a handle refers to; later lookups through the handle fail.
+        /// @return False if the handle was stale, true otherwise.
+        bool destroy(const handle item)
+        {
+            if (!contains(item))
+                return false;
+
+            const std::uint32_t position = positions_[item.index];
+            const sensor_id moved = sensors_.back();
+            sensors_[position] = moved;
+            sensors_.pop_back();
+            [&]<std::size_t... i>(std::index_sequence<i...>)
+            {
+                (((std::get<i>(columns_)[position] = std::move(std::get<i>(columns_).back())), std::get<i>(columns_).pop_back()), ...);
+            }(std::index_sequence_for<fields...> {});
+
+            positions_[moved] = position;
+            positions_[item.index] = none;
+            ++generations_[item.index];
+            return true;
+        }
+
+        /// @brief Checks whether a handle refers to live state.
+        [[nodiscard]] bool contains(const handle item) const noexcept
+        {
+            return (item.index < positions_.size()) && (positions_[item.index] != none) && (generations_[item.index] == item.generation);
+        }
+
+        /// @brief Gets the current handle of a sensor, or an invalid handle if it has no state.
+        [[nodiscard]] handle find(const sensor_id sensor) const noexcept
+        {
+            if ((sensor >= positions_.size()) || (positions_[sensor] == none))
+                return {};
+            return handle {sensor, generations_[sensor]};
+        }
+
+        /// @brief Gets one field of the state a handle refers to.
+        /// @tparam field The index of the field.
+        /// @return A pointer to the field, or nullptr if the handle is stale. Valid until the next `create()`
+        ///         or `destroy()`.
+        template <std::size_t field>
+        [[nodiscard]] auto* get(const handle item) noexcept
+        {
+            return contains(item) ? &std::get<field>(columns_)[positions_[item.index]] : nullptr;
+        }
+
+        /// @copydoc get
+        template <std::size_t field>
+        [[nodiscard]] const auto* get(const handle item) const noexcept
+        {
+            return contains(item) ? &std::get<field>(columns_)[positions_[item.index]] : nullptr;
+        }
+
+        /// @brief Gets the packed column of one field, in the same order as `sensors()`.
+        template <std::size_t field>
+        [[nodiscard]] auto column() noexcept
+        {
+            return std::span {std::get<field>(columns_)};
+        }
+
+        /// @copydoc column
+        template <std::size_t field>
+        [[nodiscard]] auto column() const noexcept
+        {
+            return std::span {std::get<field>(columns_)};
+        }
+
+        /// @brief Gets the ids of the live sensors in column order.
+        [[nodiscard]] std::span<const sensor_id> sensors() const noexcept { return sensors_; }
+
+        /// @brief Gets the current generation of every sensor id, indexed by sensor id.
+        [[nodiscard]] std::span<const std::uint32_t> generations() const noexcept { return generations_; }
+
+        /// @brief Replaces the whole pool with saved state, e.g. restored by `storage::restore()` from a checkpoint.
+        /// @details Handles issued before the state was saved stay valid, as the generations are restored too.
+        /// @param generations The generation of every sensor id, as returned by `generations()`.
+        /// @param sensors The ids of the live sensors in column order, as returned by `sensors()`.
+        /// @param columns The packed columns, in the same order as `sensors`.
+        /// @return True on success, false if the sizes disagree or a sensor id is out of range or repeated
+        ///         (the pool is then unchanged).
+        bool load(const std::span<const std::uint32_t> generations, const std::span<const sensor_id> sensors,
+                  const std::span<const fields>... columns)
+        {
+            if (((columns.size() != sensors.size()) || ...))
+                return false;
+
+            std::vector<std::uint32_t> positions(generations.size(), none);
+            for (std::size_t position {}; position < sensors.size(); ++position)
+            {
+                if ((sensors[position] >= positions.size()) || (positions[sensors[position]] != none))
+                    return false;
+                positions[sensors[position]] = static_cast<std::uint32_t>(position);
+            }
+
+            generations_.assign(generations.begin(), generations.end());
+            positions_ = std::move(positions);
+            sensors_.assign(sensors.begin(), sensors.end());
+            columns_ = std::tuple<std::vector<fields>...> {std::vector<fields>(columns.begin(), columns.end())...};
+            return true;
+        }
+
+        /// @brief Visits every live entry in column order.
+        /// @param visit Callable `void(sensor_id, fields&...)`; it must not create or destroy entries.
+        template <typename function>
+        void for_each(function&& visit)
+        {
+            [&]<std::size_t... i>(std::index_sequence<i...>)
+            {
+                for (std::size_t position {}; position < sensors_.size(); ++position)
+                    visit(sensors_[position], std::get<i>(columns_)[position]...);
+            }(std::index_sequence_for<fields...> {});
+        }
+
+        /// @brief Gets the number of live entries.
+        [[nodiscard]] std::size_t size() const noexcept { return sensors_.size(); }
+
+        /// @brief Checks whether the pool has no live entries.
+        [[nodiscard]] bool empty() const noexcept { return sensors_.empty(); }
+
+        /// @brief Reserves column space for a number of live entries.
+        void reserve(const std::size_t count)
+        {
+            sensors_.reserve(count);
+            std::apply([count](auto&... column) { (column.reserve(count), ...); }, columns_);
+        }
+
+        /// @brief Destroys all entries; every outstanding handle becomes stale.
+        void clear() noexcept
+        {
+            for (const sensor_id sensor: sensors_)
+            {
+                positions_[sensor] = none;
+                ++generations_[sensor];
+            }
+
+            sensors_.clear();
+            std::apply([](auto&... column) { (column.clear(), ...); }, columns_);
+        }
+
+    private:
+        static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+        std::vector<std::uint32_t> generations_;
+        std::vector<std::uint32_t> positions_;
+        std::vector<sensor_id> sensors_;
+        std::tuple<std::vector<fields>...> columns_;
+    };
+
+} // namespace sensor::data
@@ -0,0 +1,44 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/data/sample.hpp
+/// @brief Defines the timestamp and sensor id types and a timestamped raw scaled sensor reading.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/base.hpp>
+    #include <cstdint>
+#endif
+
+namespace kmx::sensor::data
+{
+    /// @brief A point in time, expressed in application-defined ticks (typically milliseconds since the epoch).
+    using timestamp = std::int64_t;
+
+    /// @brief A dense numeric identifier of a sensor, assigned by the application's sensor catalog.
+    using sensor_id = std::uint32_t;
+
+    /// @brief Returns the start of the fixed-width window containing a point in time.
+    /// @details Windows are aligned to multiples of `width`, so [0, width), [width, 2 * width), ...
+    ///          Negative timestamps are floored correctly.
+    /// @param time The point in time.
+    /// @param width The window width in ticks (must be positive).
+    /// @return The first timestamp of the window containing `time`.
+    [[nodiscard]] constexpr timestamp window_start(const timestamp time, const timestamp width) noexcept
+    {
+        const timestamp remainder = time % width;
+        return (remainder < 0) ? time - remainder - width : time - remainder;
+    }
+
+    /// @brief A single reading of a sensor, kept in its raw scaled representation.
+    /// @tparam traits The sensor traits describing the scaled representation.
+    template <typename traits>
+    struct sample
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+
+        /// @brief The time the reading was taken.
+        timestamp time {};
+        /// @brief The raw scaled value of the reading.
+        storage_type value {};
+    };
+
+} // namespace sensor::data
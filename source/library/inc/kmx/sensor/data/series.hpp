@@ -0,0 +1,166 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/data/series.hpp
+/// @brief Defines a columnar, time-ordered container of raw scaled sensor readings.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <kmx/sensor/index/learned.hpp>
+    #include <algorithm>
+    #include <bit>
+    #include <cstddef>
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::data
+{
+    /// @brief A time-ordered series of defined sensor readings stored as two parallel columns:
+    ///        timestamps and raw scaled values.
+    /// @details Readings must be appended in non-decreasing time order. Undefined readings are not stored.
+    ///          Time lookups use a binary search, or a learned index kept up to date on append once
+    ///          `enable_time_index()` was called.
+    /// @tparam traits The sensor traits describing the scaled representation.
+    template <typename traits>
+    class series
+    {
+    public:
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using input_type = typename traits::input_type;
+        using sensor_type = base<traits>;
+        using sample_type = sample<traits>;
+
+        /// @brief Appends a raw scaled reading.
+        /// @param time The time the reading was taken; must not precede the last stored reading.
+        /// @param value The raw scaled value.
+        /// @return True if the reading was appended, false if it is out of order or out of range.
+        bool push_back(const timestamp time, const storage_type value)
+        {
+            if ((!times_.empty() && (time < times_.back())) || (value < sensor_type::min_scaled_storage_value()) ||
+                (value > sensor_type::max_scaled_storage_value()))
+                return false;
+
+            times_.push_back(time);
+            values_.push_back(value);
+            if (time_index_)
+                time_index_->extend(times_);
+            return true;
+        }
+
+        /// @brief Appends a timestamped sample.
+        bool push_back(const sample_type& item) { return push_back(item.time, item.value); }
+
+        /// @brief Appends a sensor reading.
+        /// @return True if the reading was defined, in order and appended, false otherwise.
+        bool push_back(const timestamp time, const sensor_type& reading)
+        {
+            const auto value = reading.raw_scaled_value();
+            return value && push_back(time, *value);
+        }
+
+        /// @brief Appends the valid readings of a batch, e.g. a column checked with `data::validate()`.
+        /// @details The validity bitmap is trusted, so values are not range-checked again. Blocks of 64 readings
+        ///          that are all valid and in order are appended with one copy per column.
+        /// @param times The reading times.
+        /// @param values The raw scaled values.
+        /// @param validity The validity bitmap: bit `i % 64` of word `i / 64` is set when reading i is valid.
+        /// @return The number of appended readings; invalid readings and readings out of order are skipped.
+        std::size_t append(const std::span<const timestamp> times, const std::span<const storage_type> values,
+                           const std::span<const std::uint64_t> validity)
+        {
+            const std::size_t count = std::min({times.size(), values.size(), validity.size() * 64u});
+            const std::size_t before = times_.size();
+            for (std::size_t first {}; first < count; first += 64u)
+            {
+                const std::size_t block = std::min<std::size_t>(count - first, 64u);
+                const std::uint64_t all = (block == 64u) ? ~std::uint64_t {} : (std::uint64_t {1u} << block) - 1u;
+                std::uint64_t bits = validity[first / 64u] & all;
+                const auto block_times = times.subspan(first, block);
+                if ((bits == all) && (times_.empty() || (block_times.front() >= times_.back())) && std::ranges::is_sorted(block_times))
+                {
+                    times_.insert(times_.end(), block_times.begin(), block_times.end());
+                    values_.insert(values_.end(), values.begin() + static_cast<std::ptrdiff_t>(first),
+                                   values.begin() + static_cast<std::ptrdiff_t>(first + block));
+                    continue;
+                }
+
+                for (; bits != 0u; bits &= bits - 1u)
+                {
+                    const std::size_t index = first + static_cast<std::size_t>(std::countr_zero(bits));
+                    if (!times_.empty() && (times[index] < times_.back()))
+                        continue;
+
+                    times_.push_back(times[index]);
+                    values_.push_back(values[index]);
+                }
+            }
+
+            if (time_index_)
+                time_index_->extend(times_);
+            return times_.size() - before;
+        }
+
+        /// @brief Gets the sample at a position.
+        [[nodiscard]] sample_type operator[](const std::size_t index) const noexcept { return {times_[index], values_[index]}; }
+
+        /// @brief Gets the timestamp column.
+        [[nodiscard]] std::span<const timestamp> times() const noexcept { return times_; }
+
+        /// @brief Gets the raw scaled value column.
+        [[nodiscard]] std::span<const storage_type> values() const noexcept { return values_; }
+
+        /// @brief Gets the position of the first reading taken at or after `time`.
+        [[nodiscard]] std::size_t lower_bound(const timestamp time) const noexcept
+        {
+            if (time_index_)
+                return time_index_->lower_bound(times_, time);
+            return static_cast<std::size_t>(std::ranges::lower_bound(times_, time) - times_.begin());
+        }
+
+        /// @brief Serves `lower_bound()`, and so the time range lookups of queries, from a learned index.
+        /// @details Pays off for long, nearly regularly sampled series; the index is built over the stored
+        ///          readings now and extended as readings are appended.
+        /// @param max_error The maximum position error of the index.
+        void enable_time_index(const std::size_t max_error = 16u)
+        {
+            time_index_.emplace(max_error);
+            time_index_->build(times_);
+        }
+
+        /// @brief Drops the learned index; `lower_bound()` uses a binary search again.
+        void disable_time_index() noexcept { time_index_.reset(); }
+
+        /// @brief Gets the learned index, if enabled.
+        [[nodiscard]] const index::learned_time_index* time_index() const noexcept { return time_index_ ? &*time_index_ : nullptr; }
+
+        /// @brief Gets the number of stored readings.
+        [[nodiscard]] std::size_t size() const noexcept { return times_.size(); }
+
+        /// @brief Checks whether the series holds no readings.
+        [[nodiscard]] bool empty() const noexcept { return times_.empty(); }
+
+        /// @brief Reserves capacity for a number of readings.
+        void reserve(const std::size_t capacity)
+        {
+            times_.reserve(capacity);
+            values_.reserve(capacity);
+        }
+
+        /// @brief Removes all readings.
+        void clear() noexcept
+        {
+            times_.clear();
+            values_.clear();
+            if (time_index_)
+                time_index_->build(times_);
+        }
+
+    private:
+        std::vector<timestamp> times_;
+        std::vector<storage_type> values_;
+        std::optional<index::learned_time_index> time_index_;
+    };
+
+} // namespace sensor::data
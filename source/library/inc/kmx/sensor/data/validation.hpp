@@ -0,0 +1,98 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/data/validation.hpp
+/// @brief Defines bulk range validation of raw scaled values into a validity bitmap, for columns
+/// loaded from archives or received in network frames.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/base.hpp>
+    #include <algorithm>
+    #include <array>
+    #include <bit>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <span>
+    #include <type_traits>
+#endif
+
+namespace kmx::sensor::data
+{
+    /// @brief Gets the number of 64-bit words of a validity bitmap of `count` values.
+    [[nodiscard]] constexpr std::size_t bitmap_words(const std::size_t count) noexcept { return (count + 63u) / 64u; }
+
+    /// @brief Checks the bit of one value in a validity bitmap.
+    [[nodiscard]] constexpr bool is_valid(const std::span<const std::uint64_t> bitmap, const std::size_t index) noexcept
+    {
+        return ((bitmap[index / 64u] >> (index % 64u)) & 1u) != 0u;
+    }
+
+    /// @brief Checks raw scaled values against the valid range of a sensor type, 64 values at a time.
+    /// @details Bit `i % 64` of word `i / 64` is set when value i lies within
+    ///          [min_scaled_storage_value(), max_scaled_storage_value()], the check of `set_raw_scaled_value()`.
+    ///          Each block is compared into a byte mask with a single unsigned compare per value, a loop that
+    ///          compilers vectorize, and the mask is packed eight bytes per multiplication; unused bits of
+    ///          the last word are cleared. The bitmap is the one `series::append()` takes.
+    /// @tparam traits The sensor traits; the storage type must be an integer.
+    /// @param values The raw scaled values.
+    /// @param bitmap The validity bitmap; must hold at least `bitmap_words(values.size())` words.
+    /// @return The number of valid values.
+    template <typename traits>
+    std::size_t validate(const std::span<const typename traits::storage_type> values, const std::span<std::uint64_t> bitmap) noexcept
+    {
+        using storage_type = typename traits::storage_type;
+        static_assert(std::is_integral_v<storage_type>, "Only integer storage types can be range-checked in bulk.");
+        using unsigned_type = std::make_unsigned_t<storage_type>;
+
+        // v lies in [low, high] exactly when v - low, computed modulo 2^bits, does not exceed high - low.
+        constexpr auto low = static_cast<unsigned_type>(base<traits>::min_scaled_storage_value());
+        constexpr auto high = static_cast<unsigned_type>(base<traits>::max_scaled_storage_value());
+        constexpr auto width = static_cast<unsigned_type>(high - low);
+
+        const std::size_t words = std::min(bitmap_words(values.size()), bitmap.size());
+        std::size_t total {};
+        std::array<std::uint8_t, 64u> flags;
+        for (std::size_t word {}; word < words; ++word)
+        {
+            const std::size_t first = word * 64u;
+            const std::size_t count = std::min<std::size_t>(values.size() - first, 64u);
+            const auto check = [&](const std::size_t i)
+            {
+                const auto offset = static_cast<unsigned_type>(static_cast<unsigned_type>(values[first + i]) - low);
+                flags[i] = static_cast<std::uint8_t>(offset <= width);
+            };
+
+            // Full blocks get a fixed trip count, which even cheap vectorizer cost models accept.
+            if (count == 64u)
+                for (std::size_t i {}; i < 64u; ++i)
+                    check(i);
+            else
+            {
+                flags.fill(0u);
+                for (std::size_t i {}; i < count; ++i)
+                    check(i);
+            }
+
+            std::uint64_t bits {};
+            for (std::size_t lane {}; lane < 8u; ++lane)
+            {
+                std::uint64_t packed {};
+                if constexpr (std::endian::native == std::endian::little)
+                {
+                    // The multiplication moves byte j's low bit to bit 56 + j; no partial products overlap.
+                    std::memcpy(&packed, flags.data() + (lane * 8u), sizeof(packed));
+                    packed = (packed * 0x0102040810204080u) >> 56u;
+                }
+                else
+                    for (std::size_t j {}; j < 8u; ++j)
+                        packed |= std::uint64_t {flags[(lane * 8u) + j]} << j;
+                bits |= packed << (lane * 8u);
+            }
+
+            bitmap[word] = bits;
+            total += static_cast<std::size_t>(std::popcount(bits));
+        }
+
+        return total;
+    }
+
+} // namespace sensor::data
@@ -0,0 +1,167 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/index/learned.hpp
+/// @brief Defines a learned secondary index over a sorted timestamp column: a piecewise-linear
+/// model with bounded position error, refined by a binary search within the error window.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <algorithm>
+    #include <cstddef>
+    #include <cstdint>
+    #include <limits>
+    #include <span>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::index
+{
+    /// @brief A piecewise-linear model mapping timestamps to positions in a sorted timestamp column.
+    /// @details Segments are fitted greedily with a shrinking slope cone, so that the predicted position
+    ///          of the first occurrence of every indexed timestamp is within `max_error` of its true
+    ///          position. Nearly regularly sampled series need only a handful of segments, so a lookup
+    ///          touches the (small, cache-resident) segment table and then at most
+    ///          2 * `max_error` + 1 timestamps instead of log2(n).
+    ///          The model is built online: timestamps appended to the column are indexed with `extend`.
+    class learned_time_index
+    {
+    public:
+        /// @brief Constructor.
+        /// @param max_error The maximum distance between a predicted and the true position.
+        explicit learned_time_index(const std::size_t max_error = 16u) noexcept: max_error_ {max_error} {}
+
+        /// @brief Rebuilds the model over a whole timestamp column.
+        /// @param times The timestamps, sorted in non-decreasing order.
+        void build(const std::span<const data::timestamp> times)
+        {
+            first_keys_.clear();
+            segments_.clear();
+            indexed_ = 0u;
+            extend(times);
+        }
+
+        /// @brief Indexes timestamps appended to the column since the last `build` or `extend`.
+        /// @param times The whole timestamp column, sorted in non-decreasing order; its first
+        ///              `size()` entries must be the ones already indexed.
+        void extend(const std::span<const data::timestamp> times)
+        {
+            for (; indexed_ < times.size(); ++indexed_)
+            {
+                const data::timestamp key = times[indexed_];
+                if ((indexed_ == 0u) || (key != times[indexed_ - 1u]))
+                    add(key, indexed_);
+            }
+        }
+
+        /// @brief Finds the position of the first timestamp not less than `time`.
+        /// @param times The indexed timestamp column.
+        /// @param time The timestamp to look up.
+        /// @return The same position `std::lower_bound` would return.
+        [[nodiscard]] std::size_t lower_bound(const std::span<const data::timestamp> times, const data::timestamp time) const noexcept
+        {
+            const std::size_t count = std::min(indexed_, times.size());
+            if (segments_.empty())
+                return full_search(times, time);
+
+            const auto segment_it = std::ranges::upper_bound(first_keys_, time);
+            if (segment_it == first_keys_.begin())
+                return 0u;
+
+            const std::size_t predicted = predict(segments_[static_cast<std::size_t>(segment_it - first_keys_.begin()) - 1u], time);
+            const std::size_t lo = (predicted > max_error_) ? predicted - max_error_ : 0u;
+            const std::size_t hi = std::min(count, predicted + max_error_ + 1u);
+            if (lo < hi)
+            {
+                const auto window = times.subspan(lo, hi - lo);
+                const std::size_t position = lo + static_cast<std::size_t>(std::ranges::lower_bound(window, time) - window.begin());
+
+                // The error bound holds for indexed keys; between keys it is verified before trusting the window.
+                const bool left_ok = (lo == 0u) || (times[lo - 1u] < time);
+                const bool right_ok = (position < hi) || (hi == times.size()) || (times[hi] >= time);
+                if (left_ok && right_ok)
+                    return position;
+            }
+
+            return full_search(times, time);
+        }
+
+        /// @brief Finds the positions [first, last) of the timestamps within [from, to).
+        [[nodiscard]] std::pair<std::size_t, std::size_t> range(const std::span<const data::timestamp> times, const data::timestamp from,
+                                                                const data::timestamp to) const noexcept
+        {
+            return {lower_bound(times, from), lower_bound(times, to)};
+        }
+
+        /// @brief Gets the number of linear segments of the model.
+        [[nodiscard]] std::size_t segments() const noexcept { return segments_.size(); }
+
+        /// @brief Gets the number of indexed timestamps.
+        [[nodiscard]] std::size_t size() const noexcept { return indexed_; }
+
+        /// @brief Gets the maximum position error of the model.
+        [[nodiscard]] std::size_t max_error() const noexcept { return max_error_; }
+
+        /// @brief Gets the approximate memory footprint of the model in bytes.
+        [[nodiscard]] std::size_t bytes() const noexcept
+        {
+            return (first_keys_.capacity() * sizeof(data::timestamp)) + (segments_.capacity() * sizeof(segment));
+        }
+
+    private:
+        struct segment
+        {
+            data::timestamp first_key;
+            std::size_t first_position;
+            double slope;
+            double slope_lo;
+            double slope_hi;
+        };
+
+        /// @brief Gets the distance between two timestamps, `later` >= `earlier`, without signed overflow.
+        [[nodiscard]] static std::uint64_t distance(const data::timestamp earlier, const data::timestamp later) noexcept
+        {
+            return static_cast<std::uint64_t>(later) - static_cast<std::uint64_t>(earlier);
+        }
+
+        [[nodiscard]] std::size_t predict(const segment& item, const data::timestamp time) const noexcept
+        {
+            // Clamped before the cast: far beyond the last key the offset can exceed any position (or 2^64).
+            const double offset = item.slope * static_cast<double>(distance(item.first_key, time));
+            return item.first_position + static_cast<std::size_t>(std::clamp(offset + 0.5, 0.0, static_cast<double>(indexed_)));
+        }
+
+        [[nodiscard]] static std::size_t full_search(const std::span<const data::timestamp> times, const data::timestamp time) noexcept
+        {
+            return static_cast<std::size_t>(std::ranges::lower_bound(times, time) - times.begin());
+        }
+
+        void add(const data::timestamp key, const std::size_t position)
+        {
+            if (!segments_.empty())
+            {
+                segment& last = segments_.back();
+                const auto dk = static_cast<double>(distance(last.first_key, key));
+                const auto dp = static_cast<double>(position - last.first_position);
+                const double error = static_cast<double>(max_error_);
+                const double lo = std::max(last.slope_lo, (dp - error) / dk);
+                const double hi = std::min(last.slope_hi, (dp + error) / dk);
+                if (lo <= hi)
+                {
+                    last.slope_lo = lo;
+                    last.slope_hi = hi;
+                    last.slope = (lo + hi) / 2.0;
+                    return;
+                }
+            }
+
+            first_keys_.push_back(key);
+            segments_.push_back(segment {key, position, 0.0, 0.0, std::numeric_limits<double>::infinity()});
+        }
+
+        std::size_t max_error_;
+        std::size_t indexed_ {};
+        std::vector<data::timestamp> first_keys_;
+        std::vector<segment> segments_;
+    };
+
+} // namespace sensor::index
@@ -0,0 +1,343 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/monitoring/alerts.hpp
+/// @brief Defines a store of alert states kept as run-length intervals per sensor and rule, with
+/// merging of nearby intervals and an implicit interval tree for time range overlap queries.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <algorithm>
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #include <tuple>
+    #include <unordered_map>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::monitoring
+{
+    /// @brief Which value of an alert interval counts as its peak.
+    enum class peak_kind : std::uint8_t
+    {
+        highest, ///< The largest value (e.g. over-temperature alerts).
+        lowest,  ///< The smallest value (e.g. low-humidity alerts).
+    };
+
+    /// @brief A period during which an alert rule was active for a sensor.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    struct alert_interval
+    {
+        using storage_type = typename traits::storage_type;
+
+        /// @brief The time of the first reading that activated the alert.
+        data::timestamp start;
+        /// @brief The time of the last reading for which the alert was active.
+        data::timestamp end;
+        data::sensor_id sensor;
+        std::uint32_t rule;
+        /// @brief The most extreme raw scaled value during the interval.
+        storage_type peak;
+        /// @brief Which value counts as the peak for the rule.
+        peak_kind kind;
+    };
+
+    /// @brief Keeps the alert history of many sensors and rules as intervals instead of per-reading flags.
+    /// @details Readings are fed with their rule outcome; consecutive active readings extend one interval.
+    ///          An interval that becomes active again within `merge_gap` of its end is continued rather than
+    ///          split, so flapping alerts stay one row. Closed intervals are kept sorted by start and indexed
+    ///          by an implicit augmented interval tree (each node holds the largest end in its subtree), so an
+    ///          overlap query costs O(log n + matches). Newly closed intervals are collected in a small
+    ///          unsorted tail that is merged into the index once it grows past an eighth of it.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class alert_history
+    {
+    public:
+        using storage_type = typename traits::storage_type;
+        using interval_type = alert_interval<traits>;
+
+        /// @brief One interval as kept in snapshots, e.g. by `storage::save()` in checkpoints.
+        struct snapshot_entry
+        {
+            interval_type interval;
+            /// @brief Whether the interval is still open (not yet flushed into the history).
+            bool open;
+            /// @brief Whether the rule fired for the latest reading of an open interval.
+            bool active;
+        };
+
+        /// @brief Constructor.
+        /// @param merge_gap The largest pause, in ticks, after which a re-activated alert continues its interval.
+        explicit alert_history(const data::timestamp merge_gap = 0) noexcept: merge_gap_ {merge_gap} {}
+
+        /// @brief Records the outcome of an alert rule for one reading.
+        /// @param sensor The sensor id.
+        /// @param rule The alert rule id.
+        /// @param time The time of the reading; must not precede earlier readings of the same sensor and rule.
+        /// @param value The raw scaled value of the reading.
+        /// @param active Whether the rule fired for this reading.
+        /// @param kind Which value counts as the peak of an interval of this rule.
+        void observe(const data::sensor_id sensor, const std::uint32_t rule, const data::timestamp time, const storage_type value,
+                     const bool active, const peak_kind kind = peak_kind::highest)
+        {
+            const std::uint64_t key = (std::uint64_t {sensor} << 32u) | rule;
+            const auto it = states_.find(key);
+            if (!active)
+            {
+                if (it != states_.end())
+                    it->second.active = false;
+                return;
+            }
+
+            if (it == states_.end())
+            {
+                states_.emplace(key, state {interval_type {time, time, sensor, rule, value, kind}, true});
+                return;
+            }
+
+            state& item = it->second;
+            if (!item.active && (time - item.current.end > merge_gap_))
+            {
+                commit(item.current);
+                item.current = interval_type {time, time, sensor, rule, value, kind};
+            }
+            else
+            {
+                item.current.end = time;
+                item.current.peak = (kind == peak_kind::highest) ? std::max(item.current.peak, value) : std::min(item.current.peak, value);
+            }
+
+            item.active = true;
+            item.current.kind = kind;
+        }
+
+        /// @brief Moves intervals that ended more than `merge_gap` before `now` into the history.
+        void flush(const data::timestamp now)
+        {
+            for (auto it = states_.begin(); it != states_.end();)
+            {
+                if (!it->second.active && (now - it->second.current.end > merge_gap_))
+                {
+                    commit(it->second.current);
+                    it = states_.erase(it);
+                }
+                else
+                    ++it;
+            }
+        }
+
+        /// @brief Visits every interval overlapping [from, to], including open and not yet flushed ones.
+        /// @param visit Callable `void(const alert_interval<traits>&)`; intervals are visited in no particular order.
+        template <typename function>
+        void overlapping(const data::timestamp from, const data::timestamp to, function&& visit) const
+        {
+            query_index(from, to, visit);
+            for (const interval_type& item: tail_)
+                if ((item.start <= to) && (item.end >= from))
+                    visit(item);
+            for (const auto& [key, item]: states_)
+                if ((item.current.start <= to) && (item.current.end >= from))
+                    visit(item.current);
+        }
+
+        /// @brief Collects every interval overlapping [from, to].
+        [[nodiscard]] std::vector<interval_type> overlapping(const data::timestamp from, const data::timestamp to) const
+        {
+            std::vector<interval_type> result;
+            overlapping(from, to, [&result](const interval_type& item) { result.push_back(item); });
+            return result;
+        }
+
+        /// @brief Merges stored intervals of the same sensor and rule that are at most `gap` ticks apart.
+        /// @details Useful after raising the merge gap or importing history recorded with a smaller one.
+        void coalesce(const data::timestamp gap)
+        {
+            std::vector<interval_type> all = std::move(indexed_);
+            all.insert(all.end(), tail_.begin(), tail_.end());
+            tail_.clear();
+            std::ranges::sort(all, [](const interval_type& lhs, const interval_type& rhs)
+                              { return std::tie(lhs.sensor, lhs.rule, lhs.start) < std::tie(rhs.sensor, rhs.rule, rhs.start); });
+
+            std::vector<interval_type> merged;
+            merged.reserve(all.size());
+            for (const interval_type& item: all)
+            {
+                if (!merged.empty() && (merged.back().sensor == item.sensor) && (merged.back().rule == item.rule) &&
+                    (item.start - merged.back().end <= gap))
+                {
+                    interval_type& last = merged.back();
+                    last.end = std::max(last.end, item.end);
+                    last.peak = (item.kind == peak_kind::lowest) ? std::min(last.peak, item.peak) : std::max(last.peak, item.peak);
+                }
+                else
+                    merged.push_back(item);
+            }
+
+            indexed_ = std::move(merged);
+            rebuild();
+        }
+
+        /// @brief Gets the number of intervals in the history, excluding open and not yet flushed ones.
+        [[nodiscard]] std::size_t size() const noexcept { return indexed_.size() + tail_.size(); }
+
+        /// @brief Gets the number of open and not yet flushed intervals.
+        [[nodiscard]] std::size_t pending() const noexcept { return states_.size(); }
+
+        /// @brief Gets every stored, open and not yet flushed interval.
+        [[nodiscard]] std::vector<snapshot_entry> snapshot() const
+        {
+            std::vector<snapshot_entry> entries;
+            entries.reserve(size() + pending());
+            for (const interval_type& item: indexed_)
+                entries.push_back(snapshot_entry {item, false, false});
+            for (const interval_type& item: tail_)
+                entries.push_back(snapshot_entry {item, false, false});
+            for (const auto& [key, item]: states_)
+                entries.push_back(snapshot_entry {item.current, true, item.active});
+            return entries;
+        }
+
+        /// @brief Replaces the whole history with a snapshot and rebuilds the index.
+        /// @details The history must have been constructed with the same merge gap as the one the snapshot was taken of.
+        void load(const std::span<const snapshot_entry> entries)
+        {
+            states_.clear();
+            indexed_.clear();
+            tail_.clear();
+            for (const snapshot_entry& item: entries)
+            {
+                if (item.open)
+                    states_.insert_or_assign((std::uint64_t {item.interval.sensor} << 32u) | item.interval.rule,
+                                             state {item.interval, item.active});
+                else
+                    indexed_.push_back(item.interval);
+            }
+
+            rebuild();
+        }
+
+    private:
+        struct state
+        {
+            interval_type current;
+            bool active;
+        };
+
+        void commit(const interval_type& item)
+        {
+            tail_.push_back(item);
+            if (tail_.size() > std::max<std::size_t>(64u, indexed_.size() / 8u))
+            {
+                const auto by_start = [](const interval_type& lhs, const interval_type& rhs) { return lhs.start < rhs.start; };
+                std::ranges::sort(tail_, by_start);
+                const std::size_t middle = indexed_.size();
+                indexed_.insert(indexed_.end(), tail_.begin(), tail_.end());
+                std::inplace_merge(indexed_.begin(), indexed_.begin() + static_cast<std::ptrdiff_t>(middle), indexed_.end(), by_start);
+                tail_.clear();
+                rebuild_index();
+            }
+        }
+
+        void rebuild()
+        {
+            std::ranges::sort(indexed_, [](const interval_type& lhs, const interval_type& rhs) { return lhs.start < rhs.start; });
+            rebuild_index();
+        }
+
+        // Builds the implicit interval tree over `indexed_`: node i sits at level = number of trailing
+        // one bits of i, and `max_end_[i]` holds the largest end within its subtree.
+        void rebuild_index()
+        {
+            const std::size_t count = indexed_.size();
+            max_end_.resize(count);
+            levels_ = 0u;
+            if (count == 0u)
+                return;
+
+            std::size_t last_index {};
+            data::timestamp last_end {};
+            for (std::size_t i {}; i < count; i += 2u)
+            {
+                last_index = i;
+                last_end = max_end_[i] = indexed_[i].end;
+            }
+            for (std::size_t i {1u}; i < count; i += 2u)
+                max_end_[i] = indexed_[i].end;
+
+            unsigned level {1u};
+            for (; (std::size_t {1u} << level) <= count; ++level)
+            {
+                const std::size_t half = std::size_t {1u} << (level - 1u);
+                const std::size_t first = (half << 1u) - 1u;
+                const std::size_t step = half << 2u;
+                for (std::size_t i = first; i < count; i += step)
+                {
+                    const data::timestamp left = max_end_[i - half];
+                    const data::timestamp right = (i + half < count) ? max_end_[i + half] : last_end;
+                    max_end_[i] = std::max({indexed_[i].end, left, right});
+                }
+
+                last_index = ((last_index >> level) & 1u) ? last_index - half : last_index + half;
+                if ((last_index < count) && (max_end_[last_index] > last_end))
+                    last_end = max_end_[last_index];
+            }
+
+            levels_ = level - 1u;
+        }
+
+        template <typename function>
+        void query_index(const data::timestamp from, const data::timestamp to, function& visit) const
+        {
+            if (indexed_.empty())
+                return;
+
+            struct frame
+            {
+                std::size_t node;
+                unsigned level;
+                bool left_done;
+            };
+
+            const std::size_t count = indexed_.size();
+            std::array<frame, 64u> stack;
+            std::size_t depth {};
+            stack[depth++] = frame {(std::size_t {1u} << levels_) - 1u, levels_, false};
+            while (depth > 0u)
+            {
+                const frame top = stack[--depth];
+                if (top.level <= 3u)
+                {
+                    // Small subtrees are scanned linearly.
+                    const std::size_t begin = (top.node >> top.level) << top.level;
+                    const std::size_t end = std::min(begin + (std::size_t {1u} << (top.level + 1u)) - 1u, count);
+                    for (std::size_t i = begin; (i < end) && (indexed_[i].start <= to); ++i)
+                        if (indexed_[i].end >= from)
+                            visit(indexed_[i]);
+                }
+                else if (!top.left_done)
+                {
+                    const std::size_t left = top.node - (std::size_t {1u} << (top.level - 1u));
+                    stack[depth++] = frame {top.node, top.level, true};
+                    if ((left >= count) || (max_end_[left] >= from))
+                        stack[depth++] = frame {left, top.level - 1u, false};
+                }
+                else if ((top.node < count) && (indexed_[top.node].start <= to))
+                {
+                    if (indexed_[top.node].end >= from)
+                        visit(indexed_[top.node]);
+                    stack[depth++] = frame {top.node + (std::size_t {1u} << (top.level - 1u)), top.level - 1u, false};
+                }
+            }
+        }
+
+        data::timestamp merge_gap_;
+        std::unordered_map<std::uint64_t, state> states_;
+        std::vector<interval_type> indexed_;
+        std::vector<data::timestamp> max_end_;
+        unsigned levels_ {};
+        std::vector<interval_type> tail_;
+    };
+
+} // namespace sensor::monitoring
@@ -0,0 +1,305 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/monitoring/staleness.hpp
+/// @brief Defines heartbeat monitoring of sensors: last-seen times in a flat array and a
+/// hierarchical timing wheel that reports sensors that have been silent for too long.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <algorithm>
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <limits>
+    #include <optional>
+    #include <span>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::monitoring
+{
+    /// @brief Detects sensors that have not reported for longer than their timeout.
+    /// @details Every sensor id owns one slot of flat arrays: its last-seen time, its timeout and its
+    ///          links in an intrusive list of a timing wheel with four levels of 256 buckets, which spans
+    ///          2^32 ticks. Recording a reading of an armed sensor only stores its time; the timer is not
+    ///          moved. When the timer fires, a sensor that was seen meanwhile is re-armed at its new
+    ///          deadline, and only a sensor that was really silent is reported. Arming, refreshing and
+    ///          firing are O(1) per sensor, and `advance()` costs O(elapsed ticks + fired timers).
+    ///          The monitor is not thread-safe; call it from the ingest thread.
+    class staleness_monitor
+    {
+    public:
+        /// @brief The monitor-wide part of a snapshot, e.g. by `storage::save()` in checkpoints: the wheel's
+        ///        granularity, origin and position.
+        struct snapshot_header
+        {
+            data::timestamp resolution;
+            data::timestamp origin;
+            std::uint64_t current;
+        };
+
+        /// @brief The state of one sensor as kept in snapshots.
+        struct snapshot_entry
+        {
+            data::timestamp last_seen;
+            data::timestamp timeout;
+            /// @brief The wheel tick the sensor's timer is set for, if it is armed.
+            std::uint64_t deadline;
+            bool armed;
+        };
+
+        /// @brief Constructor.
+        /// @param sensors The number of sensor ids, [0, sensors).
+        /// @param timeout The default silence after which a sensor is reported, in ticks of the timestamps.
+        /// @param resolution The granularity of the wheel in ticks; reports are at most this late.
+        /// @param now The current time.
+        staleness_monitor(const std::size_t sensors, const data::timestamp timeout, const data::timestamp resolution,
+                          const data::timestamp now):
+            resolution_ {std::max<data::timestamp>(resolution, 1)},
+            origin_ {now},
+            last_seen_(sensors, never),
+            timeouts_(sensors, timeout),
+            deadlines_(sensors),
+            next_(sensors, none),
+            previous_(sensors, none),
+            buckets_(sensors, unarmed)
+        {
+            heads_.fill(none);
+        }
+
+        /// @brief Gets the number of sensor ids.
+        [[nodiscard]] std::size_t size() const noexcept { return last_seen_.size(); }
+
+        /// @brief Sets the timeout of one sensor; takes effect when its timer next fires or is armed.
+        void set_timeout(const data::sensor_id sensor, const data::timestamp timeout) noexcept
+        {
+            if (sensor < timeouts_.size())
+                timeouts_[sensor] = timeout;
+        }
+
+        /// @brief Records that a sensor has reported; the hot path of the monitor.
+        /// @param sensor The sensor id.
+        /// @param time The time of the report.
+        void seen(const data::sensor_id sensor, const data::timestamp time) noexcept
+        {
+            if (sensor >= last_seen_.size())
+                return;
+
+            last_seen_[sensor] = std::max(last_seen_[sensor], time);
+            if (buckets_[sensor] == unarmed)
+                arm(sensor, deadline_of(sensor));
+        }
+
+        /// @brief Stops monitoring a sensor until it reports again (e.g. when it is decommissioned).
+        void forget(const data::sensor_id sensor) noexcept
+        {
+            if (sensor >= last_seen_.size())
+                return;
+
+            if (buckets_[sensor] != unarmed)
+                unlink(sensor);
+            last_seen_[sensor] = never;
+        }
+
+        /// @brief Gets the last report time of a sensor, if it has reported.
+        [[nodiscard]] std::optional<data::timestamp> last_seen(const data::sensor_id sensor) const noexcept
+        {
+            if ((sensor >= last_seen_.size()) || (last_seen_[sensor] == never))
+                return {};
+            return last_seen_[sensor];
+        }
+
+        /// @brief Checks whether a sensor has reported and has since been reported silent.
+        [[nodiscard]] bool silent(const data::sensor_id sensor) const noexcept
+        {
+            return (sensor < last_seen_.size()) && (last_seen_[sensor] != never) && (buckets_[sensor] == unarmed);
+        }
+
+        /// @brief Advances the wheel to `now` and reports every sensor whose timeout has elapsed.
+        /// @param now The current time.
+        /// @param on_silent Callable `void(data::sensor_id, data::timestamp last_seen)`. A reported sensor is
+        ///                  re-armed by its next `seen()`; the callable may call `seen()` itself.
+        /// @return The number of reported sensors.
+        template <typename function>
+        std::size_t advance(const data::timestamp now, function&& on_silent)
+        {
+            if (now < origin_)
+                return 0u;
+
+            std::size_t reported {};
+            const auto target = static_cast<std::uint64_t>((now - origin_) / resolution_);
+            while (current_ <= target)
+            {
+                const std::uint64_t tick = current_;
+                for (unsigned level = levels - 1u; level > 0u; --level)
+                    if ((tick & ((std::uint64_t {1u} << (bucket_bits * level)) - 1u)) == 0u)
+                        cascade(level, tick);
+
+                due_.clear();
+                for (std::uint32_t sensor = detach(bucket_index(0u, tick)); sensor != none; sensor = next_[sensor])
+                    due_.push_back(sensor);
+
+                current_ = tick + 1u;
+                for (const std::uint32_t sensor: due_)
+                {
+                    // Skip sensors that an earlier callback re-armed or forgot.
+                    if ((buckets_[sensor] != unarmed) || (last_seen_[sensor] == never))
+                        continue;
+
+                    const std::uint64_t deadline = deadline_of(sensor);
+                    if (deadline > tick)
+                        arm(sensor, deadline);
+                    else
+                    {
+                        ++reported;
+                        on_silent(static_cast<data::sensor_id>(sensor), last_seen_[sensor]);
+                    }
+                }
+            }
+
+            return reported;
+        }
+
+        /// @brief Gets the monitor-wide part of a snapshot.
+        [[nodiscard]] snapshot_header snapshot_head() const noexcept { return snapshot_header {resolution_, origin_, current_}; }
+
+        /// @brief Gets the state of every sensor, indexed by sensor id.
+        [[nodiscard]] std::vector<snapshot_entry> snapshot() const
+        {
+            std::vector<snapshot_entry> entries(last_seen_.size());
+            for (std::size_t sensor {}; sensor < entries.size(); ++sensor)
+                entries[sensor] = snapshot_entry {last_seen_[sensor], timeouts_[sensor], deadlines_[sensor], buckets_[sensor] != unarmed};
+            return entries;
+        }
+
+        /// @brief Replaces the whole monitor with a snapshot; the armed timers are placed on the wheel again.
+        /// @param header The monitor-wide part of the snapshot.
+        /// @param entries The state of every sensor; their number becomes the number of sensor ids.
+        void load(const snapshot_header& header, const std::span<const snapshot_entry> entries)
+        {
+            resolution_ = std::max<data::timestamp>(header.resolution, 1);
+            origin_ = header.origin;
+            current_ = header.current;
+
+            const std::size_t count = entries.size();
+            last_seen_.resize(count);
+            timeouts_.resize(count);
+            deadlines_.resize(count);
+            next_.assign(count, none);
+            previous_.assign(count, none);
+            buckets_.assign(count, unarmed);
+            heads_.fill(none);
+            for (std::size_t sensor {}; sensor < count; ++sensor)
+            {
+                last_seen_[sensor] = entries[sensor].last_seen;
+                timeouts_[sensor] = entries[sensor].timeout;
+                deadlines_[sensor] = entries[sensor].deadline;
+                if (entries[sensor].armed)
+                    arm(static_cast<std::uint32_t>(sensor), entries[sensor].deadline);
+            }
+        }
+
+    private:
+        static constexpr unsigned levels = 4u;
+        static constexpr unsigned bucket_bits = 8u;
+        static constexpr std::size_t buckets_per_level = std::size_t {1u} << bucket_bits;
+        static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+        static constexpr std::uint16_t unarmed = std::numeric_limits<std::uint16_t>::max();
+        static constexpr data::timestamp never = std::numeric_limits<data::timestamp>::min();
+
+        [[nodiscard]] static constexpr std::uint16_t bucket_index(const unsigned level, const std::uint64_t tick) noexcept
+        {
+            return static_cast<std::uint16_t>((level * buckets_per_level) + ((tick >> (bucket_bits * level)) & (buckets_per_level - 1u)));
+        }
+
+        // The first tick at or after which the sensor's timeout has elapsed.
+        [[nodiscard]] std::uint64_t deadline_of(const std::uint32_t sensor) const noexcept
+        {
+            const data::timestamp expiry = std::max(last_seen_[sensor] + timeouts_[sensor] - origin_, data::timestamp {});
+            return static_cast<std::uint64_t>((expiry + resolution_ - 1) / resolution_);
+        }
+
+        void arm(const std::uint32_t sensor, std::uint64_t deadline) noexcept
+        {
+            deadline = std::max(deadline, current_);
+            const std::uint64_t delta = deadline - current_;
+            unsigned level {};
+            while ((level + 1u < levels) && (delta >= (std::uint64_t {1u} << (bucket_bits * (level + 1u)))))
+                ++level;
+
+            // Deadlines beyond the top level's span are parked in its furthest bucket and re-armed when they fire.
+            constexpr std::uint64_t span = std::uint64_t {1u} << (bucket_bits * levels);
+            if (delta >= span)
+                deadline = current_ + span - 1u;
+
+            deadlines_[sensor] = deadline;
+            link(sensor, bucket_index(level, deadline));
+        }
+
+        void cascade(const unsigned level, const std::uint64_t tick) noexcept
+        {
+            std::uint32_t sensor = detach(bucket_index(level, tick));
+            while (sensor != none)
+            {
+                const std::uint32_t following = next_[sensor];
+                arm(sensor, deadlines_[sensor]);
+                sensor = following;
+            }
+        }
+
+        void link(const std::uint32_t sensor, const std::uint16_t bucket) noexcept
+        {
+            buckets_[sensor] = bucket;
+            previous_[sensor] = none;
+            next_[sensor] = heads_[bucket];
+            if (heads_[bucket] != none)
+                previous_[heads_[bucket]] = sensor;
+            heads_[bucket] = sensor;
+        }
+
+        void unlink(const std::uint32_t sensor) noexcept
+        {
+            if (previous_[sensor] != none)
+                next_[previous_[sensor]] = next_[sensor];
+            else
+                heads_[buckets_[sensor]] = next_[sensor];
+            if (next_[sensor] != none)
+                previous_[next_[sensor]] = previous_[sensor];
+            buckets_[sensor] = unarmed;
+        }
+
+        // Empties a bucket and returns its former list; the sensors on it count as unarmed.
+        [[nodiscard]] std::uint32_t detach(const std::uint16_t bucket) noexcept
+        {
+            const std::uint32_t first = std::exchange(heads_[bucket], none);
+            for (std::uint32_t sensor = first; sensor != none; sensor = next_[sensor])
+                buckets_[sensor] = unarmed;
+            return first;
+        }
+
+        data::timestamp resolution_;
+        data::timestamp origin_;
+        std::uint64_t current_ {};
+        std::vector<data::timestamp> last_seen_;
+        std::vector<data::timestamp> timeouts_;
+        std::vector<std::uint64_t> deadlines_;
+        std::vector<std::uint32_t> next_;
+        std::vector<std::uint32_t> previous_;
+        std::vector<std::uint16_t> buckets_;
+        std::array<std::uint32_t, levels * buckets_per_level> heads_ {};
+        std::vector<std::uint32_t> due_;
+    };
+
+    /// @brief Returns an `advance()` callback that marks the latest value of each silent sensor undefined.
+    /// @param latest The latest value of every sensor (e.g. `data::temperature`), indexed by sensor id.
+    template <typename sensor_type>
+    [[nodiscard]] auto clear_latest(const std::span<sensor_type> latest) noexcept
+    {
+        return [latest](const data::sensor_id sensor, const data::timestamp) noexcept
+        {
+            if (sensor < latest.size())
+                latest[sensor].clear();
+        };
+    }
+
+} // namespace sensor::monitoring
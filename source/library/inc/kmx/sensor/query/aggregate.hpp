@@ -0,0 +1,285 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/query/aggregate.hpp
+/// @brief Defines mergeable aggregate states over raw scaled sensor values and an inclusive
+/// scaled value range used to translate physical predicates into integer bounds.
+/// Every aggregate offers `add` for single values and `add_batch` for contiguous blocks; the
+/// latter is written as a plain reduction loop that compilers vectorize.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/base.hpp>
+    #include <algorithm>
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <type_traits>
+#endif
+
+namespace kmx::sensor::query
+{
+    /// @brief The integer type wide enough to accumulate sums of scaled values of a sensor type.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    using accumulator_type = std::conditional_t<std::is_signed_v<typename traits::storage_type>, std::int64_t, std::uint64_t>;
+
+    /// @brief An inclusive range [lo, hi] of raw scaled values.
+    /// @details Physical comparisons are translated into scaled bounds once, so that predicates can be
+    ///          evaluated with two integer compares per value. A range with lo > hi matches nothing.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    struct scaled_range
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using input_type = typename traits::input_type;
+        using sensor_type = data::base<traits>;
+
+        /// @brief The smallest matching scaled value.
+        storage_type lo = sensor_type::min_scaled_storage_value();
+        /// @brief The largest matching scaled value.
+        storage_type hi = sensor_type::max_scaled_storage_value();
+
+        /// @brief Checks whether the range matches no value at all.
+        [[nodiscard]] constexpr bool empty() const noexcept { return lo > hi; }
+
+        /// @brief Checks whether a scaled value lies within the range.
+        [[nodiscard]] constexpr bool contains(const storage_type val) const noexcept { return (val >= lo) && (val <= hi); }
+
+        /// @brief Intersects this range with another one.
+        [[nodiscard]] constexpr scaled_range operator&(const scaled_range& other) const noexcept
+        {
+            return {std::max(lo, other.lo), std::min(hi, other.hi)};
+        }
+
+        /// @brief Returns the range matching every valid scaled value.
+        [[nodiscard]] static constexpr scaled_range all() noexcept { return {}; }
+
+        /// @brief Returns a range matching nothing.
+        [[nodiscard]] static constexpr scaled_range none() noexcept { return {storage_type {1}, storage_type {0}}; }
+
+        /// @brief Range of values whose physical value is greater than `val`.
+        [[nodiscard]] static constexpr scaled_range greater(const input_type val) noexcept
+        {
+            return at_least(val, false);
+        }
+
+        /// @brief Range of values whose physical value is greater than or equal to `val`.
+        [[nodiscard]] static constexpr scaled_range greater_equal(const input_type val) noexcept
+        {
+            return at_least(val, true);
+        }
+
+        /// @brief Range of values whose physical value is less than `val`.
+        [[nodiscard]] static constexpr scaled_range less(const input_type val) noexcept
+        {
+            return at_most(val, false);
+        }
+
+        /// @brief Range of values whose physical value is less than or equal to `val`.
+        [[nodiscard]] static constexpr scaled_range less_equal(const input_type val) noexcept
+        {
+            return at_most(val, true);
+        }
+
+        /// @brief Range of values whose physical value lies within [from, to].
+        [[nodiscard]] static constexpr scaled_range between(const input_type from, const input_type to) noexcept
+        {
+            return greater_equal(from) & less_equal(to);
+        }
+
+    private:
+        // The bound nearest to `val` is probed in the physical domain so that the scaled range agrees
+        // exactly with comparing `base::value()` against `val`.
+        [[nodiscard]] static constexpr scaled_range at_least(const input_type val, const bool inclusive) noexcept
+        {
+            constexpr storage_type max_scaled = sensor_type::max_scaled_storage_value();
+            const storage_type bound = sensor_type::to_scaled(val);
+            const input_type physical = sensor_type::to_physical(bound);
+            if (inclusive ? (physical >= val) : (physical > val))
+                return {bound, max_scaled};
+            if (bound == max_scaled)
+                return none();
+            return {static_cast<storage_type>(bound + 1), max_scaled};
+        }
+
+        [[nodiscard]] static constexpr scaled_range at_most(const input_type val, const bool inclusive) noexcept
+        {
+            constexpr storage_type min_scaled = sensor_type::min_scaled_storage_value();
+            const storage_type bound = sensor_type::to_scaled(val);
+            const input_type physical = sensor_type::to_physical(bound);
+            if (inclusive ? (physical <= val) : (physical < val))
+                return {min_scaled, bound};
+            if (bound == min_scaled)
+                return none();
+            return {min_scaled, static_cast<storage_type>(bound - 1)};
+        }
+    };
+
+    /// @brief Counts the aggregated values.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    struct count
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using result_type = std::uint64_t;
+
+        constexpr void add(const storage_type) noexcept { ++state_; }
+        constexpr void add_batch(const std::span<const storage_type> values) noexcept { state_ += values.size(); }
+        constexpr void merge(const count& other) noexcept { state_ += other.state_; }
+        [[nodiscard]] constexpr result_type result() const noexcept { return state_; }
+
+        std::uint64_t state_ {};
+    };
+
+    /// @brief Counts the aggregated values that fall within a scaled range (e.g. "humidity > 80%").
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    struct count_in
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using result_type = std::uint64_t;
+
+        constexpr count_in() noexcept = default;
+        constexpr explicit count_in(const scaled_range<traits> range) noexcept: range_ {range} {}
+
+        constexpr void add(const storage_type val) noexcept { state_ += range_.contains(val) ? 1u : 0u; }
+        constexpr void add_batch(const std::span<const storage_type> values) noexcept
+        {
+            std::uint64_t matches {};
+            for (const storage_type val: values)
+                matches += range_.contains(val) ? 1u : 0u;
+            state_ += matches;
+        }
+        constexpr void merge(const count_in& other) noexcept { state_ += other.state_; }
+        [[nodiscard]] constexpr result_type result() const noexcept { return state_; }
+
+        scaled_range<traits> range_ {};
+        std::uint64_t state_ {};
+    };
+
+    /// @brief Sums the aggregated scaled values.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    struct sum
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using result_type = accumulator_type<traits>;
+
+        constexpr void add(const storage_type val) noexcept { state_ += val; }
+        constexpr void add_batch(const std::span<const storage_type> values) noexcept
+        {
+            result_type total {};
+            for (const storage_type val: values)
+                total += val;
+            state_ += total;
+        }
+        constexpr void merge(const sum& other) noexcept { state_ += other.state_; }
+        [[nodiscard]] constexpr result_type result() const noexcept { return state_; }
+
+        result_type state_ {};
+    };
+
+    /// @brief Tracks the smallest aggregated scaled value.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    struct minimum
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using result_type = std::optional<storage_type>;
+
+        constexpr void add(const storage_type val) noexcept { state_ = state_ ? std::min(*state_, val) : val; }
+        constexpr void add_batch(const std::span<const storage_type> values) noexcept
+        {
+            if (values.empty())
+                return;
+            storage_type lowest = values.front();
+            for (const storage_type val: values)
+                lowest = std::min(lowest, val);
+            add(lowest);
+        }
+        constexpr void merge(const minimum& other) noexcept
+        {
+            if (other.state_)
+                add(*other.state_);
+        }
+        [[nodiscard]] constexpr result_type result() const noexcept { return state_; }
+
+        result_type state_ {};
+    };
+
+    /// @brief Tracks the largest aggregated scaled value.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    struct maximum
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using result_type = std::optional<storage_type>;
+
+        constexpr void add(const storage_type val) noexcept { state_ = state_ ? std::max(*state_, val) : val; }
+        constexpr void add_batch(const std::span<const storage_type> values) noexcept
+        {
+            if (values.empty())
+                return;
+            storage_type highest = values.front();
+            for (const storage_type val: values)
+                highest = std::max(highest, val);
+            add(highest);
+        }
+        constexpr void merge(const maximum& other) noexcept
+        {
+            if (other.state_)
+                add(*other.state_);
+        }
+        [[nodiscard]] constexpr result_type result() const noexcept { return state_; }
+
+        result_type state_ {};
+    };
+
+    /// @brief Computes the arithmetic mean of the aggregated values in physical units.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    struct mean
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using input_type = typename traits::input_type;
+        using result_type = std::optional<input_type>;
+
+        constexpr void add(const storage_type val) noexcept
+        {
+            sum_ += val;
+            ++count_;
+        }
+
+        constexpr void add_batch(const std::span<const storage_type> values) noexcept
+        {
+            accumulator_type<traits> total {};
+            for (const storage_type val: values)
+                total += val;
+            sum_ += total;
+            count_ += values.size();
+        }
+
+        constexpr void merge(const mean& other) noexcept
+        {
+            sum_ += other.sum_;
+            count_ += other.count_;
+        }
+
+        [[nodiscard]] constexpr result_type result() const noexcept
+        {
+            if (count_ == 0u)
+                return {};
+            const auto scaled_mean = static_cast<input_type>(sum_) / static_cast<input_type>(count_);
+            return scaled_mean * traits::resolution;
+        }
+
+        accumulator_type<traits> sum_ {};
+        std::uint64_t count_ {};
+    };
+
+} // namespace sensor::query
@@ -0,0 +1,172 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/query/cache.hpp
+/// @brief Defines an LRU cache with a byte budget for aggregate query results, keyed by query
+/// fingerprint, time range and the versions of the chunks the query touched.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <cstddef>
+    #include <cstdint>
+    #include <initializer_list>
+    #include <iterator>
+    #include <list>
+    #include <map>
+    #include <tuple>
+#endif
+
+namespace kmx::sensor::query
+{
+    /// @brief Folds a sequence of 64-bit words into a single fingerprint.
+    /// @details Used both for query fingerprints (series id, predicate bounds, aggregate kind) and for
+    ///          digests of chunk version ids. Not a cryptographic hash.
+    /// @param words The words to combine, in order.
+    /// @return The combined fingerprint.
+    [[nodiscard]] constexpr std::uint64_t fingerprint(const std::initializer_list<std::uint64_t> words) noexcept
+    {
+        std::uint64_t state = 0xcbf29ce484222325u;
+        for (const std::uint64_t word: words)
+        {
+            state ^= word + 0x9e3779b97f4a7c15u + (state << 6u) + (state >> 2u);
+            state *= 0x100000001b3u;
+        }
+
+        return state;
+    }
+
+    /// @brief A cache of mergeable aggregate states for time-range queries.
+    /// @details Each entry covers one query (fingerprint) over [from, to) and remembers the digest of
+    ///          the chunk versions it was computed from. Sealed chunks are immutable, so an entry is
+    ///          valid for as long as that digest is unchanged. A query over [from, to2) can reuse a
+    ///          valid entry over [from, to1) with to1 < to2 and only compute [to1, to2).
+    ///          Entries are evicted in least-recently-used order once the byte budget is exceeded.
+    /// @tparam aggregate A mergeable aggregate state from sensor/query/aggregate.hpp.
+    template <typename aggregate>
+    class result_cache
+    {
+    public:
+        using aggregate_type = aggregate;
+
+        /// @brief Constructor.
+        /// @param byte_budget The maximum number of bytes accounted to cached entries.
+        explicit result_cache(const std::size_t byte_budget) noexcept: byte_budget_ {byte_budget} {}
+
+        /// @brief Returns the cached or computed aggregate of a query over [from, to).
+        /// @param query The query fingerprint.
+        /// @param from The inclusive start of the time range.
+        /// @param to The exclusive end of the time range.
+        /// @param digest Callable `std::uint64_t(timestamp from, timestamp to)` returning the digest of the
+        ///               versions of all chunks overlapping a range.
+        /// @param compute Callable `aggregate_type(timestamp from, timestamp to)` evaluating the query over a range.
+        /// @return The aggregate state of the query over [from, to).
+        template <typename digest_function, typename compute_function>
+        aggregate_type get(const std::uint64_t query, const data::timestamp from, const data::timestamp to, digest_function&& digest,
+                           compute_function&& compute)
+        {
+            const std::uint64_t versions = digest(from, to);
+            auto it = index_.upper_bound(key_type {query, from, to});
+            while (it != index_.begin())
+            {
+                const auto candidate = std::prev(it);
+                const auto& [candidate_query, candidate_from, candidate_to] = candidate->first;
+                if ((candidate_query != query) || (candidate_from != from))
+                    break;
+
+                const auto cached = candidate->second;
+                const bool exact = candidate_to == to;
+                if (cached->versions != (exact ? versions : digest(from, candidate_to)))
+                {
+                    // The chunks changed underneath this entry; it can never be valid again.
+                    erase(candidate);
+                    it = index_.upper_bound(key_type {query, from, to});
+                    continue;
+                }
+
+                entries_.splice(entries_.begin(), entries_, cached);
+                ++hits_;
+                if (exact)
+                    return cached->state;
+
+                aggregate_type result = cached->state;
+                result.merge(compute(candidate_to, to));
+                insert(query, from, to, versions, result);
+                return result;
+            }
+
+            ++misses_;
+            aggregate_type result = compute(from, to);
+            insert(query, from, to, versions, result);
+            return result;
+        }
+
+        /// @brief Stores an aggregate state, replacing any entry for the same query and range.
+        /// @param query The query fingerprint.
+        /// @param from The inclusive start of the time range.
+        /// @param to The exclusive end of the time range.
+        /// @param versions The digest of the versions of the chunks overlapping [from, to).
+        /// @param state The aggregate state.
+        void insert(const std::uint64_t query, const data::timestamp from, const data::timestamp to, const std::uint64_t versions,
+                    const aggregate_type& state)
+        {
+            const key_type key {query, from, to};
+            if (const auto it = index_.find(key); it != index_.end())
+                erase(it);
+
+            entries_.push_front(entry {key, versions, state});
+            index_.emplace(key, entries_.begin());
+            bytes_ += entry_bytes;
+            while ((bytes_ > byte_budget_) && !entries_.empty())
+                erase(index_.find(entries_.back().key));
+        }
+
+        /// @brief Removes all entries.
+        void clear() noexcept
+        {
+            index_.clear();
+            entries_.clear();
+            bytes_ = 0u;
+        }
+
+        /// @brief Gets the number of cached entries.
+        [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+
+        /// @brief Gets the number of bytes accounted to cached entries.
+        [[nodiscard]] std::size_t bytes() const noexcept { return bytes_; }
+
+        /// @brief Gets the number of lookups answered fully or partially from the cache.
+        [[nodiscard]] std::uint64_t hits() const noexcept { return hits_; }
+
+        /// @brief Gets the number of lookups computed from scratch.
+        [[nodiscard]] std::uint64_t misses() const noexcept { return misses_; }
+
+    private:
+        using key_type = std::tuple<std::uint64_t, data::timestamp, data::timestamp>;
+
+        struct entry
+        {
+            key_type key;
+            std::uint64_t versions;
+            aggregate_type state;
+        };
+
+        using entry_list = std::list<entry>;
+        using index_type = std::map<key_type, typename entry_list::iterator>;
+
+        /// @brief Approximate bytes of one entry: the list node, the index node and their links.
+        static constexpr std::size_t entry_bytes = sizeof(entry) + sizeof(typename index_type::value_type) + 6u * sizeof(void*);
+
+        void erase(const typename index_type::iterator it)
+        {
+            entries_.erase(it->second);
+            index_.erase(it);
+            bytes_ -= entry_bytes;
+        }
+
+        std::size_t byte_budget_;
+        std::size_t bytes_ {};
+        std::uint64_t hits_ {};
+        std::uint64_t misses_ {};
+        entry_list entries_;
+        index_type index_;
+    };
+
+} // namespace sensor::query
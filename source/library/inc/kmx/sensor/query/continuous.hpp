@@ -0,0 +1,162 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/query/continuous.hpp
+/// @brief Defines a standing (continuous) query that keeps a tumbling-window aggregate per group
+/// up to date as readings are ingested, so that its result can be read in O(1).
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <kmx/sensor/query/aggregate.hpp>
+    #include <functional>
+    #include <optional>
+    #include <span>
+    #include <unordered_map>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::query
+{
+    /// @brief A materialized view of one aggregate per group over fixed, aligned time windows.
+    /// @details Each ingested reading updates the aggregate of its group's current window in O(1).
+    ///          When a reading opens a newer window, the finished window becomes the group's
+    ///          `previous()` result. Readings older than the group's current window are rejected.
+    ///          Example: "15-minute max temperature per room" is
+    ///          `continuous_query<room_id, maximum<temperature_traits>> {15 * 60 * 1000}`.
+    /// @tparam key The group key type (e.g. a room or site identifier).
+    /// @tparam aggregate A mergeable aggregate state from sensor/query/aggregate.hpp.
+    /// @tparam hash The hash function for the group key.
+    template <typename key, typename aggregate, typename hash = std::hash<key>>
+    class continuous_query
+    {
+    public:
+        using key_type = key;
+        using aggregate_type = aggregate;
+        using traits_type = typename aggregate::traits_type;
+        using storage_type = typename traits_type::storage_type;
+        using result_type = typename aggregate::result_type;
+
+        /// @brief The state of one group as kept in snapshots, e.g. by `storage::save()` in checkpoints.
+        struct snapshot_entry
+        {
+            key_type group;
+            data::timestamp start;
+            aggregate_type current;
+            aggregate_type previous;
+        };
+
+        /// @brief Constructor.
+        /// @param window_width The width of the tumbling windows in ticks (must be positive).
+        /// @param prototype The empty aggregate state every new window starts from, carrying any
+        ///                  configuration of the aggregate (e.g. the range of `count_in`).
+        explicit continuous_query(const data::timestamp window_width, const aggregate_type prototype = {}) noexcept:
+            window_width_ {window_width}, prototype_ {prototype}
+        {
+        }
+
+        /// @brief Folds a raw scaled reading into the view.
+        /// @param group The group the reading belongs to.
+        /// @param time The time the reading was taken.
+        /// @param value The raw scaled value of the reading.
+        /// @return True if the reading was applied, false if it is older than the group's current window.
+        bool ingest(const key_type& group, const data::timestamp time, const storage_type value)
+        {
+            const data::timestamp start = data::window_start(time, window_width_);
+            const auto [it, inserted] = groups_.try_emplace(group, state {start, prototype_, prototype_});
+            state& item = it->second;
+            if (!inserted && (start != item.start))
+            {
+                if (start < item.start)
+                    return false;
+
+                // Only an immediately following window keeps the finished one as `previous()`.
+                item.previous = (start == item.start + window_width_) ? item.current : prototype_;
+                item.current = prototype_;
+                item.start = start;
+            }
+
+            item.current.add(value);
+            return true;
+        }
+
+        /// @brief Folds a timestamped sample into the view.
+        bool ingest(const key_type& group, const data::sample<traits_type>& reading)
+        {
+            return ingest(group, reading.time, reading.value);
+        }
+
+        /// @brief Folds a sensor reading into the view. Undefined readings are ignored.
+        /// @return True if the reading was defined and applied, false otherwise.
+        bool ingest(const key_type& group, const data::timestamp time, const data::base<traits_type>& reading)
+        {
+            const auto value = reading.raw_scaled_value();
+            return value && ingest(group, time, *value);
+        }
+
+        /// @brief Gets the aggregate of the group's current (open) window.
+        /// @return The aggregate result, or the result of an empty aggregate for unknown groups.
+        [[nodiscard]] result_type current(const key_type& group) const
+        {
+            const auto it = groups_.find(group);
+            return (it != groups_.end()) ? it->second.current.result() : prototype_.result();
+        }
+
+        /// @brief Gets the aggregate of the window immediately preceding the group's current one.
+        /// @return The aggregate result, or the result of an empty aggregate if there is none.
+        [[nodiscard]] result_type previous(const key_type& group) const
+        {
+            const auto it = groups_.find(group);
+            return (it != groups_.end()) ? it->second.previous.result() : prototype_.result();
+        }
+
+        /// @brief Gets the start of the group's current window, if the group has been seen.
+        [[nodiscard]] std::optional<data::timestamp> current_window(const key_type& group) const
+        {
+            const auto it = groups_.find(group);
+            if (it == groups_.end())
+                return {};
+            return it->second.start;
+        }
+
+        /// @brief Gets the width of the tumbling windows in ticks.
+        [[nodiscard]] data::timestamp window_width() const noexcept { return window_width_; }
+
+        /// @brief Gets the number of groups tracked by the view.
+        [[nodiscard]] std::size_t size() const noexcept { return groups_.size(); }
+
+        /// @brief Drops all groups.
+        void clear() noexcept { groups_.clear(); }
+
+        /// @brief Gets the state of all groups.
+        [[nodiscard]] std::vector<snapshot_entry> snapshot() const
+        {
+            std::vector<snapshot_entry> entries;
+            entries.reserve(groups_.size());
+            for (const auto& [group, item]: groups_)
+                entries.push_back(snapshot_entry {group, item.start, item.current, item.previous});
+            return entries;
+        }
+
+        /// @brief Replaces the state of all groups with a snapshot.
+        /// @details The view must have been constructed with the same window width and prototype
+        ///          as the one the snapshot was taken of.
+        void load(const std::span<const snapshot_entry> entries)
+        {
+            groups_.clear();
+            groups_.reserve(entries.size());
+            for (const snapshot_entry& item: entries)
+                groups_.insert_or_assign(item.group, state {item.start, item.current, item.previous});
+        }
+
+    private:
+        struct state
+        {
+            data::timestamp start;
+            aggregate_type current;
+            aggregate_type previous;
+        };
+
+        data::timestamp window_width_;
+        aggregate_type prototype_;
+        std::unordered_map<key_type, state, hash> groups_;
+    };
+
+} // namespace sensor::query
@@ -0,0 +1,179 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/query/engine.hpp
+/// @brief Defines a small vectorized execution engine (scan, filter, project, aggregate) over
+/// the columns of a `data::series`, together with a fluent builder for its query plans.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/series.hpp>
+    #include <kmx/sensor/query/aggregate.hpp>
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <limits>
+    #include <tuple>
+#endif
+
+namespace kmx::sensor::query
+{
+    /// @brief The number of rows processed per batch by the engine.
+    inline constexpr std::size_t batch_size = 1024u;
+
+    /// @brief Positions of the selected rows within one batch.
+    struct selection
+    {
+        std::array<std::uint16_t, batch_size> rows;
+        std::size_t size {};
+    };
+
+    /// @brief Fills a selection vector with the rows of a batch whose value lies within a range.
+    /// @details The loop is branch-free: every row is written, and the output cursor advances only
+    ///          for matches.
+    /// @param values The values of the batch (at most `batch_size`).
+    /// @param range The inclusive scaled range to keep.
+    /// @param output The selection vector to fill.
+    template <data::integer_scaled traits>
+    constexpr void select(const std::span<const typename traits::storage_type> values, const scaled_range<traits>& range,
+                          selection& output) noexcept
+    {
+        std::size_t selected {};
+        for (std::size_t i {}; i < values.size(); ++i)
+        {
+            output.rows[selected] = static_cast<std::uint16_t>(i);
+            selected += range.contains(values[i]) ? 1u : 0u;
+        }
+
+        output.size = selected;
+    }
+
+    /// @brief A query plan over one series: a time range, a value predicate pushed down as scaled
+    ///        bounds, and terminal project or aggregate operators.
+    /// @details Example:
+    ///          `query::scan(series).between(t0, t1).greater(80.0f).aggregate(count<humidity_traits> {}, maximum<humidity_traits> {})`
+    /// @tparam traits The sensor traits of the scanned series.
+    template <data::integer_scaled traits>
+    class plan
+    {
+    public:
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using input_type = typename traits::input_type;
+        using series_type = data::series<traits>;
+        using range_type = scaled_range<traits>;
+
+        /// @brief Constructor.
+        /// @param source The series to scan; must outlive the plan.
+        explicit plan(const series_type& source) noexcept: source_ {&source} {}
+
+        /// @brief Restricts the scan to readings taken in [from, to).
+        plan& between(const data::timestamp from, const data::timestamp to) noexcept
+        {
+            from_ = from;
+            to_ = to;
+            return *this;
+        }
+
+        /// @brief Keeps only readings whose scaled value lies in `range`.
+        plan& where(const range_type& range) noexcept
+        {
+            range_ = range_ & range;
+            return *this;
+        }
+
+        /// @brief Keeps only readings whose physical value is greater than `val`.
+        plan& greater(const input_type val) noexcept { return where(range_type::greater(val)); }
+
+        /// @brief Keeps only readings whose physical value is greater than or equal to `val`.
+        plan& greater_equal(const input_type val) noexcept { return where(range_type::greater_equal(val)); }
+
+        /// @brief Keeps only readings whose physical value is less than `val`.
+        plan& less(const input_type val) noexcept { return where(range_type::less(val)); }
+
+        /// @brief Keeps only readings whose physical value is less than or equal to `val`.
+        plan& less_equal(const input_type val) noexcept { return where(range_type::less_equal(val)); }
+
+        /// @brief Gets the effective scaled range of the pushed-down predicates.
+        [[nodiscard]] const range_type& range() const noexcept { return range_; }
+
+        /// @brief Runs the plan and folds the selected values into one or more aggregates.
+        /// @param prototypes The initial aggregate states (usually default constructed).
+        /// @return The aggregate states after the scan, in the order given.
+        template <typename... aggregate_types>
+        [[nodiscard]] std::tuple<aggregate_types...> aggregate(const aggregate_types... prototypes) const
+        {
+            std::tuple<aggregate_types...> result {prototypes...};
+            run([&result](const std::span<const storage_type> values, const std::span<const data::timestamp>)
+                { std::apply([values](auto&... items) { (items.add_batch(values), ...); }, result); });
+            return result;
+        }
+
+        /// @brief Runs the plan and materializes the selected readings.
+        [[nodiscard]] series_type project() const
+        {
+            series_type result;
+            run(
+                [&result](const std::span<const storage_type> values, const std::span<const data::timestamp> times)
+                {
+                    for (std::size_t i {}; i < values.size(); ++i)
+                        result.push_back(times[i], values[i]);
+                });
+            return result;
+        }
+
+    private:
+        /// @brief Drives the scan batch by batch, handing contiguous selected values (and their times)
+        ///        to `consume`.
+        template <typename consumer>
+        void run(consumer&& consume) const
+        {
+            if (range_.empty())
+                return;
+
+            const std::size_t first = source_->lower_bound(from_);
+            const std::size_t last = (to_ == std::numeric_limits<data::timestamp>::max()) ? source_->size() : source_->lower_bound(to_);
+            const auto values = source_->values();
+            const auto times = source_->times();
+            const bool filtered = (range_.lo > min_scaled) || (range_.hi < max_scaled);
+
+            selection rows;
+            std::array<storage_type, batch_size> value_buffer;
+            std::array<data::timestamp, batch_size> time_buffer;
+            for (std::size_t begin = first; begin < last; begin += batch_size)
+            {
+                const std::size_t length = std::min(batch_size, last - begin);
+                const auto batch_values = values.subspan(begin, length);
+                const auto batch_times = times.subspan(begin, length);
+                if (!filtered)
+                {
+                    consume(batch_values, batch_times);
+                    continue;
+                }
+
+                select<traits>(batch_values, range_, rows);
+                for (std::size_t i {}; i < rows.size; ++i)
+                {
+                    value_buffer[i] = batch_values[rows.rows[i]];
+                    time_buffer[i] = batch_times[rows.rows[i]];
+                }
+
+                consume(std::span<const storage_type> {value_buffer.data(), rows.size},
+                        std::span<const data::timestamp> {time_buffer.data(), rows.size});
+            }
+        }
+
+        static constexpr storage_type min_scaled = data::base<traits>::min_scaled_storage_value();
+        static constexpr storage_type max_scaled = data::base<traits>::max_scaled_storage_value();
+
+        const series_type* source_;
+        data::timestamp from_ = std::numeric_limits<data::timestamp>::min();
+        data::timestamp to_ = std::numeric_limits<data::timestamp>::max();
+        range_type range_ = range_type::all();
+    };
+
+    /// @brief Starts building a query plan over a series.
+    template <data::integer_scaled traits>
+    [[nodiscard]] plan<traits> scan(const data::series<traits>& source) noexcept
+    {
+        return plan<traits> {source};
+    }
+
+} // namespace sensor::query
@@ -0,0 +1,283 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/query/integral.hpp
+/// @brief Defines time integrals of irregularly sampled raw scaled sensor values: time-weighted
+/// averages and heating/cooling degree-time (degree-days), kept exactly in integer arithmetic.
+/// Integrals are accumulated as twice the area (scaled value × ticks) so that linear interpolation
+/// stays exact. Areas are 64-bit; gaps between consecutive readings are expected to stay far below
+/// 2^63 / (2 * codes^2) ticks (about 10^9 ticks for 16-bit sensors).
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/series.hpp>
+    #include <algorithm>
+    #include <cstddef>
+    #include <cstdint>
+    #include <optional>
+    #include <span>
+    #include <thread>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::query
+{
+    /// @brief How a signal is reconstructed between two readings.
+    enum class interpolation : std::uint8_t
+    {
+        step,   ///< A reading holds until the next one (sample-and-hold).
+        linear, ///< The signal changes linearly between consecutive readings.
+    };
+
+    /// @brief What is integrated over time.
+    enum class integrand : std::uint8_t
+    {
+        signal,  ///< The scaled value itself (time-weighted average).
+        heating, ///< The shortfall below a base value, max(0, base - value) (heating degree-time).
+        cooling, ///< The excess above a base value, max(0, value - base) (cooling degree-time).
+    };
+
+    /// @brief Twice the area of one segment of a signal.
+    template <interpolation mode>
+    [[nodiscard]] constexpr std::int64_t segment(const std::int64_t from, const std::int64_t to, const std::int64_t duration) noexcept
+    {
+        if constexpr (mode == interpolation::step)
+            return 2 * from * duration;
+        else
+            return (from + to) * duration;
+    }
+
+    /// @brief Twice the area of the positive part of one segment of a signal.
+    /// @details With linear interpolation a segment crossing zero contributes the triangle above zero,
+    ///          which is rounded to the nearest integer (of the doubled area).
+    template <interpolation mode>
+    [[nodiscard]] constexpr std::int64_t positive_segment(const std::int64_t from, const std::int64_t to,
+                                                          const std::int64_t duration) noexcept
+    {
+        if constexpr (mode == interpolation::step)
+            return 2 * std::max<std::int64_t>(from, 0) * duration;
+        else
+        {
+            if ((from >= 0) && (to >= 0))
+                return (from + to) * duration;
+            if ((from <= 0) && (to <= 0))
+                return 0;
+
+            // Triangle of height `high` over the part of the segment before the zero crossing.
+            const std::int64_t high = std::max(from, to);
+            const std::int64_t rise = high - std::min(from, to);
+            return ((2 * high * high * duration) + rise) / (2 * rise);
+        }
+    }
+
+    /// @brief Computes twice the area of a reconstructed signal between consecutive readings.
+    /// @details Each segment contributes independently of the others, so the loop is a plain
+    ///          reduction; the signal and step kernels are branch-free and vectorize.
+    /// @tparam mode The interpolation between readings.
+    /// @param times The non-decreasing timestamps of the readings.
+    /// @param values The raw scaled values of the readings.
+    /// @param kind What is integrated.
+    /// @param base The scaled base value of degree-time integrands.
+    /// @return Twice the integral from the first to the last reading, in scaled value × ticks.
+    template <interpolation mode, typename storage_type>
+    [[nodiscard]] std::int64_t doubled_area(const std::span<const data::timestamp> times, const std::span<const storage_type> values,
+                                            const integrand kind = integrand::signal, const std::int64_t base = 0) noexcept
+    {
+        const std::size_t count = std::min(times.size(), values.size());
+        if (count < 2u)
+            return 0;
+
+        std::int64_t total {};
+        switch (kind)
+        {
+            case integrand::signal:
+                for (std::size_t i {1u}; i < count; ++i)
+                    total += segment<mode>(values[i - 1u], values[i], times[i] - times[i - 1u]);
+                break;
+            case integrand::heating:
+                for (std::size_t i {1u}; i < count; ++i)
+                    total += positive_segment<mode>(base - values[i - 1u], base - values[i], times[i] - times[i - 1u]);
+                break;
+            case integrand::cooling:
+                for (std::size_t i {1u}; i < count; ++i)
+                    total += positive_segment<mode>(values[i - 1u] - base, values[i] - base, times[i] - times[i - 1u]);
+                break;
+        }
+
+        return total;
+    }
+
+    /// @brief Integrates an irregularly sampled signal incrementally.
+    /// @details Readings are added in time order; the integral covers the time from the first reading
+    ///          to the last one and, for an open window, can be extended to any later time by holding the
+    ///          last reading. `restart()` begins the next window at the last reading. The state is trivially
+    ///          copyable, so arrays of integrals (e.g. the output of `integrate()`) are checkpointed as they are
+    ///          by the vector overloads of `storage::save()` and `storage::restore()`.
+    /// @tparam traits The sensor traits.
+    /// @tparam mode The interpolation between readings.
+    template <data::integer_scaled traits, interpolation mode = interpolation::step>
+    class time_integral
+    {
+    public:
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using input_type = typename traits::input_type;
+        using sample_type = data::sample<traits>;
+
+        /// @brief Constructor of a time-weighted average of the signal.
+        constexpr time_integral() noexcept = default;
+
+        /// @brief Constructor.
+        /// @param kind What is integrated.
+        /// @param base The scaled base value of degree-time integrands (e.g. `base<traits>::to_scaled(18.0f)`).
+        constexpr time_integral(const integrand kind, const storage_type base) noexcept: kind_ {kind}, base_ {base} {}
+
+        /// @brief Adds a reading.
+        /// @return True if the reading was added, false if it is older than the last reading.
+        constexpr bool add(const data::timestamp time, const storage_type value) noexcept
+        {
+            if (last_)
+            {
+                if (time < last_->time)
+                    return false;
+                area_ += between(*last_, sample_type {time, value});
+            }
+            else
+                first_ = time;
+
+            last_ = sample_type {time, value};
+            return true;
+        }
+
+        /// @brief Adds a timestamped sample.
+        constexpr bool add(const sample_type& reading) noexcept { return add(reading.time, reading.value); }
+
+        /// @brief Adds a time-ordered block of readings.
+        /// @return True if the readings were added, false if the block starts before the last reading.
+        bool add_batch(const std::span<const data::timestamp> times, const std::span<const storage_type> values) noexcept
+        {
+            const std::size_t count = std::min(times.size(), values.size());
+            if ((count == 0u) || !add(times.front(), values.front()))
+                return count == 0u;
+
+            area_ += query::doubled_area<mode, storage_type>(times.first(count), values.first(count), kind_, base_);
+            last_ = sample_type {times[count - 1u], values[count - 1u]};
+            return true;
+        }
+
+        /// @brief Begins a new window at the last reading, dropping the accumulated integral.
+        constexpr void restart() noexcept
+        {
+            area_ = 0;
+            if (last_)
+                first_ = last_->time;
+        }
+
+        /// @brief Gets twice the exact integral from the first to the last reading, in scaled value × ticks.
+        [[nodiscard]] constexpr std::int64_t doubled_area() const noexcept { return area_; }
+
+        /// @brief Gets twice the exact integral up to `end`, holding the last reading after it.
+        [[nodiscard]] constexpr std::int64_t doubled_area(const data::timestamp end) const noexcept
+        {
+            if (!last_ || (end <= last_->time))
+                return area_;
+            return area_ + between(*last_, sample_type {end, last_->value});
+        }
+
+        /// @brief Gets the integrated time span from the first to the last reading, in ticks.
+        [[nodiscard]] constexpr data::timestamp duration() const noexcept { return last_ ? last_->time - first_ : 0; }
+
+        /// @brief Gets the integrated time span up to `end`, in ticks.
+        [[nodiscard]] constexpr data::timestamp duration(const data::timestamp end) const noexcept
+        {
+            return last_ ? std::max(end, last_->time) - first_ : 0;
+        }
+
+        /// @brief Gets the time-weighted average of the integrand in physical units.
+        /// @return The average, or an empty optional if no time has elapsed.
+        [[nodiscard]] constexpr std::optional<input_type> average() const noexcept { return average_of(area_, duration()); }
+
+        /// @brief Gets the time-weighted average of the integrand up to `end` in physical units.
+        [[nodiscard]] constexpr std::optional<input_type> average(const data::timestamp end) const noexcept
+        {
+            return average_of(doubled_area(end), duration(end));
+        }
+
+        /// @brief Gets the integral in physical units × days (e.g. °C·d for heating degree-days).
+        /// @param ticks_per_day The number of ticks in a day (86'400'000 for millisecond timestamps).
+        /// @param end The end of the window; the last reading is held until then.
+        [[nodiscard]] constexpr input_type degree_days(const data::timestamp ticks_per_day, const data::timestamp end) const noexcept
+        {
+            return static_cast<input_type>(static_cast<double>(doubled_area(end)) * static_cast<double>(traits::resolution) /
+                                           (2.0 * static_cast<double>(ticks_per_day)));
+        }
+
+        /// @brief Gets the last added reading, if any.
+        [[nodiscard]] constexpr std::optional<sample_type> last() const noexcept { return last_; }
+
+    private:
+        [[nodiscard]] constexpr std::int64_t between(const sample_type& from, const sample_type& to) const noexcept
+        {
+            const data::timestamp duration = to.time - from.time;
+            switch (kind_)
+            {
+                case integrand::heating:
+                    return positive_segment<mode>(base_ - from.value, base_ - to.value, duration);
+                case integrand::cooling:
+                    return positive_segment<mode>(from.value - base_, to.value - base_, duration);
+                default:
+                    return segment<mode>(from.value, to.value, duration);
+            }
+        }
+
+        [[nodiscard]] static constexpr std::optional<input_type> average_of(const std::int64_t area,
+                                                                            const data::timestamp duration) noexcept
+        {
+            if (duration <= 0)
+                return {};
+            return static_cast<input_type>(static_cast<double>(area) * static_cast<double>(traits::resolution) /
+                                           (2.0 * static_cast<double>(duration)));
+        }
+
+        integrand kind_ = integrand::signal;
+        std::int64_t base_ {};
+        data::timestamp first_ {};
+        std::int64_t area_ {};
+        std::optional<sample_type> last_;
+    };
+
+    /// @brief Integrates the series of many sensors in parallel.
+    /// @details The sensors are split into contiguous ranges, one per worker thread; each output
+    ///          starts as a copy of `prototype` and gets the whole series of its sensor added.
+    /// @param sensors The series of the sensors.
+    /// @param prototype The (empty) integral every sensor starts from, carrying its integrand and base.
+    /// @param output One integral per sensor; must be as large as `sensors`.
+    /// @param threads The number of worker threads (0 selects the hardware concurrency).
+    template <data::integer_scaled traits, interpolation mode>
+    void integrate(const std::span<const data::series<traits>> sensors, const time_integral<traits, mode>& prototype,
+                   const std::span<time_integral<traits, mode>> output, unsigned threads = 0u)
+    {
+        const std::size_t count = std::min(sensors.size(), output.size());
+        if (threads == 0u)
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, count));
+
+        const auto work = [&](const std::size_t from, const std::size_t to)
+        {
+            for (std::size_t i = from; i < to; ++i)
+            {
+                output[i] = prototype;
+                output[i].add_batch(sensors[i].times(), sensors[i].values());
+            }
+        };
+
+        if (threads <= 1u)
+        {
+            work(0u, count);
+            return;
+        }
+
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (unsigned t {}; t < threads; ++t)
+            workers.emplace_back(work, count * t / threads, count * (t + 1u) / threads);
+    }
+
+} // namespace sensor::query
@@ -0,0 +1,267 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/query/percentile.hpp
+/// @brief Defines exact percentiles over raw scaled sensor values using a histogram with one
+/// counter per scaled code, as a mergeable aggregate and as a sliding time-window operator.
+/// Small-range sensors have few codes (humidity: 201, temperature: 1001), so values can be added
+/// and removed in O(1) and a percentile is found by scanning a coarse level of block totals first.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <algorithm>
+    #include <array>
+    #include <cmath>
+    #include <cstddef>
+    #include <cstdint>
+    #include <deque>
+    #include <optional>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::query
+{
+    /// @brief The number of distinct valid scaled values of a sensor type.
+    template <data::integer_scaled traits>
+    inline constexpr std::size_t scaled_codes =
+        static_cast<std::size_t>(static_cast<std::int64_t>(data::base<traits>::max_scaled_storage_value()) -
+                                 static_cast<std::int64_t>(data::base<traits>::min_scaled_storage_value())) +
+        1u;
+
+    /// @brief The largest number of scaled codes a histogram is kept for (16 KiB of counters).
+    inline constexpr std::size_t max_histogram_codes = 4096u;
+
+    /// @brief Satisfied by sensor types with few enough scaled codes for a histogram per aggregate (e.g.
+    ///        humidity or temperature, but not the 65536 codes of light intensity, whose histogram would be
+    ///        256 KiB inline and cost O(65536) per merge).
+    template <typename traits>
+    concept small_range = data::integer_scaled<traits> && (scaled_codes<traits> <= max_histogram_codes);
+
+    /// @brief Counts how often each valid scaled value occurs.
+    /// @details Two levels are kept: a fine counter per scaled code and a coarse total per block of
+    ///          `block_size` codes. A rank query scans the coarse totals and then one block, i.e.
+    ///          O(codes / block_size + block_size) instead of O(codes). Values outside the valid scaled
+    ///          range are clamped to it.
+    /// @tparam traits The sensor traits.
+    template <small_range traits>
+    class scaled_histogram
+    {
+    public:
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using sensor_type = data::base<traits>;
+
+        /// @brief The number of distinct valid scaled values.
+        static constexpr std::size_t codes = scaled_codes<traits>;
+        /// @brief The number of codes per coarse block.
+        static constexpr std::size_t block_size = 32u;
+        /// @brief The number of coarse blocks.
+        static constexpr std::size_t blocks = (codes + block_size - 1u) / block_size;
+
+        /// @brief Counts one occurrence of a scaled value.
+        constexpr void add(const storage_type val) noexcept
+        {
+            const std::size_t code = code_of(val);
+            ++fine_[code];
+            ++coarse_[code / block_size];
+            ++size_;
+        }
+
+        /// @brief Counts the occurrences of a block of scaled values.
+        constexpr void add_batch(const std::span<const storage_type> values) noexcept
+        {
+            for (const storage_type val: values)
+                add(val);
+        }
+
+        /// @brief Removes one occurrence of a scaled value that was added before.
+        constexpr void remove(const storage_type val) noexcept
+        {
+            const std::size_t code = code_of(val);
+            --fine_[code];
+            --coarse_[code / block_size];
+            --size_;
+        }
+
+        /// @brief Adds the counts of another histogram.
+        constexpr void merge(const scaled_histogram& other) noexcept
+        {
+            for (std::size_t i {}; i < codes; ++i)
+                fine_[i] += other.fine_[i];
+            for (std::size_t i {}; i < blocks; ++i)
+                coarse_[i] += other.coarse_[i];
+            size_ += other.size_;
+        }
+
+        /// @brief Gets the number of counted values.
+        [[nodiscard]] constexpr std::uint64_t size() const noexcept { return size_; }
+
+        /// @brief Checks whether no value is counted.
+        [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0u; }
+
+        /// @brief Gets how often a scaled value occurs.
+        [[nodiscard]] constexpr std::uint32_t count_of(const storage_type val) const noexcept { return fine_[code_of(val)]; }
+
+        /// @brief Finds the value of a given rank.
+        /// @param rank The zero-based position in ascending order.
+        /// @return The scaled value, or an empty optional if `rank >= size()`.
+        [[nodiscard]] constexpr std::optional<storage_type> select(std::uint64_t rank) const noexcept
+        {
+            if (rank >= size_)
+                return {};
+
+            std::size_t block {};
+            while (rank >= coarse_[block])
+                rank -= coarse_[block++];
+
+            std::size_t code = block * block_size;
+            while (rank >= fine_[code])
+                rank -= fine_[code++];
+            return value_of(code);
+        }
+
+        /// @brief Finds the nearest-rank quantile: the smallest value with at least `q * size()` values at or below it.
+        /// @param q The quantile in [0, 1] (0.5 for the median, 0.95 for p95).
+        /// @return The scaled value, or an empty optional if the histogram is empty.
+        [[nodiscard]] constexpr std::optional<storage_type> quantile(const double q) const noexcept
+        {
+            if (size_ == 0u)
+                return {};
+            const auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(size_)));
+            return select((rank == 0u) ? 0u : rank - 1u);
+        }
+
+        /// @brief Removes all counts.
+        constexpr void clear() noexcept
+        {
+            fine_ = {};
+            coarse_ = {};
+            size_ = 0u;
+        }
+
+    private:
+        [[nodiscard]] static constexpr std::size_t code_of(const storage_type val) noexcept
+        {
+            const storage_type clamped = std::clamp(val, sensor_type::min_scaled_storage_value(), sensor_type::max_scaled_storage_value());
+            return static_cast<std::size_t>(static_cast<std::int64_t>(clamped) -
+                                            static_cast<std::int64_t>(sensor_type::min_scaled_storage_value()));
+        }
+
+        [[nodiscard]] static constexpr storage_type value_of(const std::size_t code) noexcept
+        {
+            return static_cast<storage_type>(static_cast<std::int64_t>(sensor_type::min_scaled_storage_value()) +
+                                             static_cast<std::int64_t>(code));
+        }
+
+        std::array<std::uint32_t, codes> fine_ {};
+        std::array<std::uint32_t, blocks> coarse_ {};
+        std::uint64_t size_ {};
+    };
+
+    /// @brief Computes an exact nearest-rank quantile (e.g. the median or p95) of the aggregated values.
+    /// @details Unlike the other aggregates its state is a full histogram, so merging costs O(codes).
+    /// @tparam traits The sensor traits.
+    template <small_range traits>
+    struct quantile
+    {
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using result_type = std::optional<storage_type>;
+
+        constexpr quantile() noexcept = default;
+        constexpr explicit quantile(const double q) noexcept: q_ {q} {}
+
+        constexpr void add(const storage_type val) noexcept { state_.add(val); }
+        constexpr void add_batch(const std::span<const storage_type> values) noexcept { state_.add_batch(values); }
+        constexpr void merge(const quantile& other) noexcept { state_.merge(other.state_); }
+        [[nodiscard]] constexpr result_type result() const noexcept { return state_.quantile(q_); }
+
+        double q_ = 0.5;
+        scaled_histogram<traits> state_ {};
+    };
+
+    /// @brief Keeps exact quantiles of the readings of the last `width` ticks.
+    /// @details Each reading is added to a histogram when it enters the window and removed when it
+    ///          leaves it, so both take O(1) regardless of the window length, and any quantile can be read
+    ///          without sorting the window.
+    /// @tparam traits The sensor traits.
+    template <small_range traits>
+    class sliding_quantile
+    {
+    public:
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using sample_type = data::sample<traits>;
+        /// @brief The state kept in snapshots, e.g. by `storage::save()` in checkpoints: the readings of the window.
+        using snapshot_entry = sample_type;
+
+        /// @brief Constructor.
+        /// @param width The window length in ticks; the window ending at `t` covers (t - width, t].
+        explicit sliding_quantile(const data::timestamp width) noexcept: width_ {width} {}
+
+        /// @brief Adds a reading and drops the readings that fall out of the window.
+        /// @return True if the reading was added, false if it is older than the latest reading.
+        bool push(const data::timestamp time, const storage_type value)
+        {
+            if (!window_.empty() && (time < window_.back().time))
+                return false;
+
+            window_.push_back(sample_type {time, value});
+            histogram_.add(value);
+            advance(time);
+            return true;
+        }
+
+        /// @brief Adds a timestamped sample.
+        bool push(const sample_type& reading) { return push(reading.time, reading.value); }
+
+        /// @brief Moves the end of the window to `time` without adding a reading.
+        void advance(const data::timestamp time) noexcept
+        {
+            while (!window_.empty() && (window_.front().time <= time - width_))
+            {
+                histogram_.remove(window_.front().value);
+                window_.pop_front();
+            }
+        }
+
+        /// @brief Gets a nearest-rank quantile of the window, or an empty optional if it is empty.
+        [[nodiscard]] std::optional<storage_type> quantile(const double q) const noexcept { return histogram_.quantile(q); }
+
+        /// @brief Gets the (lower) median of the window, or an empty optional if it is empty.
+        [[nodiscard]] std::optional<storage_type> median() const noexcept { return histogram_.quantile(0.5); }
+
+        /// @brief Gets the histogram of the window.
+        [[nodiscard]] const scaled_histogram<traits>& histogram() const noexcept { return histogram_; }
+
+        /// @brief Gets the number of readings in the window.
+        [[nodiscard]] std::size_t size() const noexcept { return window_.size(); }
+
+        /// @brief Gets the window length in ticks.
+        [[nodiscard]] data::timestamp width() const noexcept { return width_; }
+
+        /// @brief Drops all readings.
+        void clear() noexcept
+        {
+            window_.clear();
+            histogram_.clear();
+        }
+
+        /// @brief Gets the readings of the window in time order.
+        [[nodiscard]] std::vector<snapshot_entry> snapshot() const { return {window_.begin(), window_.end()}; }
+
+        /// @brief Replaces the window with a snapshot; the histogram is rebuilt from its readings.
+        /// @details The operator must have been constructed with the same width as the one the snapshot was taken of.
+        void load(const std::span<const snapshot_entry> entries)
+        {
+            clear();
+            for (const snapshot_entry& item: entries)
+                (void) push(item);
+        }
+
+    private:
+        data::timestamp width_;
+        std::deque<sample_type> window_;
+        scaled_histogram<traits> histogram_;
+    };
+
+} // namespace sensor::query
@@ -0,0 +1,384 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/replication/link.hpp
+/// @brief Defines log-shipping replication of sensor readings from a primary (leader) to a hot
+/// standby (follower) process over a Unix domain socket, with batching and acknowledgement modes.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/replication/segment.hpp>
+    #include <array>
+    #include <cerrno>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <deque>
+    #include <filesystem>
+    #include <optional>
+    #include <span>
+    #include <string_view>
+    #include <utility>
+    #include <vector>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace kmx::sensor::replication
+{
+    /// @brief When the leader learns that the follower has applied a segment.
+    enum class acknowledgement : std::uint8_t
+    {
+        none,         ///< Segments are not acknowledged; cheapest, but failover may lose the last batches.
+        asynchronous, ///< Acknowledgements are collected without waiting; `acknowledged()` trails `sequence()`.
+        synchronous,  ///< `flush()` returns only once the follower has applied the segment.
+    };
+
+    /// @brief A connected or listening Unix domain stream socket.
+    class unix_socket
+    {
+    public:
+        unix_socket(const unix_socket&) = delete;
+        unix_socket& operator=(const unix_socket&) = delete;
+
+        unix_socket(unix_socket&& other) noexcept: descriptor_ {std::exchange(other.descriptor_, -1)} {}
+
+        unix_socket& operator=(unix_socket&& other) noexcept
+        {
+            if (this != &other)
+            {
+                close();
+                descriptor_ = std::exchange(other.descriptor_, -1);
+            }
+
+            return *this;
+        }
+
+        ~unix_socket() noexcept { close(); }
+
+        /// @brief Creates a socket listening at a path, replacing a stale socket file.
+        /// @return The listening socket, or an empty optional on error.
+        [[nodiscard]] static std::optional<unix_socket> listen(const std::filesystem::path& path) noexcept
+        {
+            const auto address = make_address(path);
+            if (!address)
+                return {};
+
+            unix_socket result {::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+            ::unlink(path.c_str());
+            if ((result.descriptor_ < 0) ||
+                (::bind(result.descriptor_, reinterpret_cast<const ::sockaddr*>(&*address), sizeof(*address)) != 0) ||
+                (::listen(result.descriptor_, 1) != 0))
+                return {};
+            return result;
+        }
+
+        /// @brief Connects to a socket listening at a path.
+        /// @return The connected socket, or an empty optional on error.
+        [[nodiscard]] static std::optional<unix_socket> connect(const std::filesystem::path& path) noexcept
+        {
+            const auto address = make_address(path);
+            if (!address)
+                return {};
+
+            unix_socket result {::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+            if ((result.descriptor_ < 0) ||
+                (::connect(result.descriptor_, reinterpret_cast<const ::sockaddr*>(&*address), sizeof(*address)) != 0))
+                return {};
+            return result;
+        }
+
+        /// @brief Waits for and accepts a connection on a listening socket.
+        /// @return The connected socket, or an empty optional on error.
+        [[nodiscard]] std::optional<unix_socket> accept() const noexcept
+        {
+            unix_socket result {::accept4(descriptor_, nullptr, nullptr, SOCK_CLOEXEC)};
+            if (result.descriptor_ < 0)
+                return {};
+            return result;
+        }
+
+        /// @brief Sends a whole buffer.
+        /// @return True on success, false if the connection failed.
+        bool send_all(const std::span<const std::uint8_t> bytes) noexcept
+        {
+            for (std::size_t sent {}; sent < bytes.size();)
+            {
+                const ::ssize_t result = ::send(descriptor_, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result <= 0)
+                    return false;
+                sent += static_cast<std::size_t>(result);
+            }
+
+            return true;
+        }
+
+        /// @brief Receives exactly `bytes.size()` bytes, blocking as needed.
+        /// @return True on success, false if the connection was closed or failed.
+        bool receive_all(const std::span<std::uint8_t> bytes) noexcept
+        {
+            for (std::size_t received {}; received < bytes.size();)
+            {
+                const ::ssize_t result = ::recv(descriptor_, bytes.data() + received, bytes.size() - received, 0);
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result <= 0)
+                    return false;
+                received += static_cast<std::size_t>(result);
+            }
+
+            return true;
+        }
+
+        /// @brief Receives whatever is available without blocking.
+        /// @return The number of bytes received (possibly 0), or an empty optional if the connection failed.
+        std::optional<std::size_t> receive_available(const std::span<std::uint8_t> bytes) noexcept
+        {
+            const ::ssize_t result = ::recv(descriptor_, bytes.data(), bytes.size(), MSG_DONTWAIT);
+            if (result < 0)
+            {
+                if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
+                    return 0u;
+                return {};
+            }
+
+            if ((result == 0) && !bytes.empty())
+                return {};
+            return static_cast<std::size_t>(result);
+        }
+
+    private:
+        explicit unix_socket(const int descriptor) noexcept: descriptor_ {descriptor} {}
+
+        [[nodiscard]] static std::optional<::sockaddr_un> make_address(const std::filesystem::path& path) noexcept
+        {
+            ::sockaddr_un address {};
+            address.sun_family = AF_UNIX;
+            const std::string_view text {path.c_str()};
+            if (text.size() >= sizeof(address.sun_path))
+                return {};
+            std::memcpy(address.sun_path, text.data(), text.size());
+            return address;
+        }
+
+        void close() noexcept
+        {
+            if (descriptor_ >= 0)
+                ::close(descriptor_);
+            descriptor_ = -1;
+        }
+
+        int descriptor_ = -1;
+    };
+
+    /// @brief The primary side of a replication link: batches readings into segments and ships them.
+    /// @details Every encoded segment is kept until the follower acknowledges it (or, with
+    ///          `acknowledgement::none`, until it was sent completely), so a failed link loses nothing:
+    ///          `reconnect()` ships the kept segments again over a new connection.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    class leader
+    {
+    public:
+        using storage_type = typename traits::storage_type;
+        using record_type = record<traits>;
+
+        /// @brief The default number of readings per segment.
+        static constexpr std::size_t default_batch_rows = 1024u;
+
+        /// @brief Constructor.
+        /// @param connection The socket connected to the follower.
+        /// @param mode The acknowledgement mode.
+        /// @param batch_rows The number of readings after which a segment is shipped automatically.
+        /// @param sequence The sequence number of the last segment the follower already has.
+        leader(unix_socket connection, const acknowledgement mode, const std::size_t batch_rows = default_batch_rows,
+               const std::uint64_t sequence = 0u):
+            connection_ {std::move(connection)}, mode_ {mode}, batch_rows_ {batch_rows}, sequence_ {sequence}, acknowledged_ {sequence}
+        {
+            batch_.reserve(batch_rows_);
+        }
+
+        /// @brief Logs a reading, shipping the batch once it is full.
+        /// @return False if shipping failed (the link must then be re-established), true otherwise.
+        bool append(const data::sensor_id sensor, const data::timestamp time, const storage_type value)
+        {
+            batch_.push_back(record_type {sensor, time, value});
+            return (batch_.size() < batch_rows_) || flush();
+        }
+
+        /// @brief Ships the pending readings as one segment.
+        /// @return False if the connection failed (the segment is kept for `reconnect()`), true otherwise.
+        bool flush()
+        {
+            if (batch_.empty())
+                return collect_acknowledgements(false);
+
+            std::vector<std::uint8_t> bytes;
+            const std::uint32_t flags = (mode_ == acknowledgement::none) ? 0u : segment_header::flag_acknowledge;
+            encode_segment<traits>(sequence_ + 1u, flags, batch_, bytes);
+            unacknowledged_.push_back(kept_segment {sequence_ + 1u, std::move(bytes)});
+            ++sequence_;
+            batch_.clear();
+            return send(unacknowledged_.back()) && collect_acknowledgements(mode_ == acknowledgement::synchronous);
+        }
+
+        /// @brief Replaces a failed connection and ships every segment the follower has not acknowledged again.
+        /// @details The follower skips (and acknowledges) segments it already applied, so resending is safe
+        ///          even when only the acknowledgement was lost.
+        /// @param connection The socket connected to the follower.
+        /// @return False if the new connection failed as well, true otherwise.
+        bool reconnect(unix_socket connection)
+        {
+            connection_ = std::move(connection);
+            ack_filled_ = 0u;
+            for (const kept_segment& item: unacknowledged_)
+                if ((item.sequence > acknowledged_) && !send(item))
+                    return false;
+            return collect_acknowledgements(mode_ == acknowledgement::synchronous);
+        }
+
+        /// @brief Ships the pending readings and waits until the follower has acknowledged every segment.
+        /// @details Used for a graceful switchover; a no-op wait with `acknowledgement::none`.
+        /// @return False if the connection failed, true otherwise.
+        bool drain() { return flush() && collect_acknowledgements(true); }
+
+        /// @brief Gets the sequence number of the last shipped segment.
+        [[nodiscard]] std::uint64_t sequence() const noexcept { return sequence_; }
+
+        /// @brief Gets the sequence number of the last segment acknowledged by the follower.
+        [[nodiscard]] std::uint64_t acknowledged() const noexcept { return acknowledged_; }
+
+        /// @brief Gets the number of readings waiting for the next segment.
+        [[nodiscard]] std::size_t pending() const noexcept { return batch_.size(); }
+
+        /// @brief Gets the number of shipped segments kept until the follower acknowledges them.
+        [[nodiscard]] std::size_t unacknowledged() const noexcept { return unacknowledged_.size(); }
+
+    private:
+        struct kept_segment
+        {
+            std::uint64_t sequence;
+            std::vector<std::uint8_t> bytes;
+        };
+
+        bool send(const kept_segment& item)
+        {
+            if (!connection_.send_all(item.bytes))
+                return false;
+
+            // Without acknowledgements, a completely sent segment is as safe as it gets.
+            if (mode_ == acknowledgement::none)
+            {
+                const std::uint64_t sent = item.sequence;
+                std::erase_if(unacknowledged_, [sent](const kept_segment& kept) { return kept.sequence <= sent; });
+            }
+            return true;
+        }
+
+        bool collect_acknowledgements(const bool wait)
+        {
+            if (mode_ == acknowledgement::none)
+                return true;
+
+            while (true)
+            {
+                const auto free = std::span {ack_bytes_}.subspan(ack_filled_);
+                if (wait && (acknowledged_ < sequence_))
+                {
+                    if (!connection_.receive_all(free))
+                        return false;
+                    ack_filled_ = ack_bytes_.size();
+                }
+                else
+                {
+                    const auto received = connection_.receive_available(free);
+                    if (!received)
+                        return false;
+                    ack_filled_ += *received;
+                }
+
+                if (ack_filled_ < ack_bytes_.size())
+                    return !wait || (acknowledged_ >= sequence_);
+
+                std::memcpy(&acknowledged_, ack_bytes_.data(), sizeof(acknowledged_));
+                ack_filled_ = 0u;
+                while (!unacknowledged_.empty() && (unacknowledged_.front().sequence <= acknowledged_))
+                    unacknowledged_.pop_front();
+                if (wait && (acknowledged_ >= sequence_))
+                    return true;
+            }
+        }
+
+        unix_socket connection_;
+        acknowledgement mode_;
+        std::size_t batch_rows_;
+        std::uint64_t sequence_;
+        std::uint64_t acknowledged_;
+        std::vector<record_type> batch_;
+        std::deque<kept_segment> unacknowledged_;
+        std::array<std::uint8_t, sizeof(std::uint64_t)> ack_bytes_ {};
+        std::size_t ack_filled_ {};
+    };
+
+    /// @brief The standby side of a replication link: receives segments and applies them in order.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    class follower
+    {
+    public:
+        using record_type = record<traits>;
+
+        /// @brief Constructor.
+        /// @param connection The socket connected to the leader.
+        /// @param applied The sequence number of the last segment already applied (e.g. restored from a checkpoint).
+        explicit follower(unix_socket connection, const std::uint64_t applied = 0u) noexcept:
+            connection_ {std::move(connection)}, applied_ {applied}
+        {
+        }
+
+        /// @brief Receives one segment, applies its records and acknowledges it if requested.
+        /// @param apply Callable `void(const record<traits>&)` applying one record to the local store.
+        /// @return False if the connection closed, a segment is corrupt or a segment is missing; true otherwise.
+        template <typename apply_function>
+        bool receive(apply_function&& apply)
+        {
+            std::array<std::uint8_t, sizeof(segment_header)> header_bytes;
+            if (!connection_.receive_all(header_bytes))
+                return false;
+
+            const auto header = read_segment_header(header_bytes);
+            if (!header || (header->sequence > applied_ + 1u))
+                return false;
+
+            payload_.resize(header->payload_bytes);
+            records_.clear();
+            if (!connection_.receive_all(payload_) || !decode_segment<traits>(*header, payload_, records_))
+                return false;
+
+            // A segment already applied is resent by a reconnected leader that missed its acknowledgement.
+            if (header->sequence == applied_ + 1u)
+            {
+                for (const record_type& item: records_)
+                    apply(item);
+                applied_ = header->sequence;
+            }
+
+            if ((header->flags & segment_header::flag_acknowledge) == 0u)
+                return true;
+
+            std::array<std::uint8_t, sizeof(std::uint64_t)> ack;
+            std::memcpy(ack.data(), &applied_, sizeof(applied_));
+            return connection_.send_all(ack);
+        }
+
+        /// @brief Gets the sequence number of the last applied segment.
+        [[nodiscard]] std::uint64_t applied() const noexcept { return applied_; }
+
+    private:
+        unix_socket connection_;
+        std::uint64_t applied_;
+        std::vector<std::uint8_t> payload_;
+        std::vector<record_type> records_;
+    };
+
+} // namespace sensor::replication
@@ -0,0 +1,141 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/replication/segment.hpp
+/// @brief Defines write-ahead log segments: checksummed, sequence-numbered batches of encoded
+/// sensor readings as shipped from a primary to a standby process.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/codec/hash.hpp>
+    #include <kmx/sensor/codec/varint.hpp>
+    #include <kmx/sensor/data/sample.hpp>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <optional>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::replication
+{
+    /// @brief One logged reading.
+    /// @details Values travel as zigzag varints of their raw integers, so only sensor types with integer
+    ///          storage can be replicated; floating-point (e.g. half) storage is rejected at compile time.
+    /// @tparam traits The sensor traits.
+    template <data::integer_scaled traits>
+    struct record
+    {
+        using storage_type = typename traits::storage_type;
+
+        data::sensor_id sensor;
+        data::timestamp time;
+        storage_type value;
+    };
+
+    /// @brief The fixed header preceding the payload of every segment.
+    struct segment_header
+    {
+        static constexpr std::uint32_t expected_magic = 0x4B4D5857u; // "KMXW"
+        /// @brief Flag set when the sender waits for an acknowledgement of the segment.
+        static constexpr std::uint32_t flag_acknowledge = 1u;
+        /// @brief The largest accepted payload, so that a corrupt header cannot make a receiver allocate
+        ///        without bound; segments of millions of readings stay well below it.
+        static constexpr std::uint32_t max_payload_bytes = 16u << 20u;
+        /// @brief The smallest encoded record: one byte each for the sensor id, time delta and value.
+        static constexpr std::uint32_t min_record_bytes = 3u;
+
+        std::uint32_t magic;
+        std::uint32_t flags;
+        /// @brief The sequence number of the segment; consecutive segments increase it by one.
+        std::uint64_t sequence;
+        /// @brief The number of records in the payload.
+        std::uint32_t records;
+        /// @brief The size of the payload in bytes.
+        std::uint32_t payload_bytes;
+        /// @brief `codec::hash_bytes` of the payload, seeded with `seed()` so that it covers the header too.
+        std::uint64_t checksum;
+
+        /// @brief Gets the checksum seed derived from the header fields other than the magic and checksum.
+        [[nodiscard]] constexpr std::uint64_t seed() const noexcept
+        {
+            return codec::mix(codec::mix(sequence ^ flags) ^ ((std::uint64_t {records} << 32u) | payload_bytes));
+        }
+    };
+
+    /// @brief Encodes records as a segment.
+    /// @details Each record is stored as a varint sensor id, a zigzag varint time delta to the previous
+    ///          record and a zigzag varint raw value, so batches of concurrent readings take a few bytes each.
+    /// @param sequence The sequence number of the segment.
+    /// @param flags The segment flags.
+    /// @param records The records to encode.
+    /// @param output The buffer the segment (header and payload) is appended to.
+    template <data::integer_scaled traits>
+    void encode_segment(const std::uint64_t sequence, const std::uint32_t flags, const std::span<const record<traits>> records,
+                        std::vector<std::uint8_t>& output)
+    {
+        const std::size_t header_offset = output.size();
+        output.resize(header_offset + sizeof(segment_header));
+
+        data::timestamp previous {};
+        for (const record<traits>& item: records)
+        {
+            codec::write_varint(output, item.sensor);
+            codec::write_signed_varint(output, item.time - previous);
+            codec::write_signed_varint(output, static_cast<std::int64_t>(item.value));
+            previous = item.time;
+        }
+
+        const auto payload = std::as_bytes(std::span {output}.subspan(header_offset + sizeof(segment_header)));
+        segment_header header {segment_header::expected_magic, flags, sequence, static_cast<std::uint32_t>(records.size()),
+                               static_cast<std::uint32_t>(payload.size()), 0u};
+        header.checksum = codec::hash_bytes(payload, header.seed());
+        std::memcpy(output.data() + header_offset, &header, sizeof(header));
+    }
+
+    /// @brief Reads and validates a segment header.
+    /// @return The header, or an empty optional if the buffer is too short, the magic is wrong or the
+    ///         sizes are impossible (larger than `max_payload_bytes`, or more records than the payload can hold).
+    [[nodiscard]] inline std::optional<segment_header> read_segment_header(const std::span<const std::uint8_t> input) noexcept
+    {
+        if (input.size() < sizeof(segment_header))
+            return {};
+
+        segment_header header;
+        std::memcpy(&header, input.data(), sizeof(header));
+        if ((header.magic != segment_header::expected_magic) || (header.payload_bytes > segment_header::max_payload_bytes) ||
+            (header.records > header.payload_bytes / segment_header::min_record_bytes))
+            return {};
+        return header;
+    }
+
+    /// @brief Decodes the payload of a segment.
+    /// @param header The segment header.
+    /// @param payload The payload bytes following the header.
+    /// @param output The vector the records are appended to.
+    /// @return True on success, false if the payload is truncated, holds fewer bytes than its records need
+    ///         or fails the checksum over header and payload.
+    template <data::integer_scaled traits>
+    bool decode_segment(const segment_header& header, std::span<const std::uint8_t> payload, std::vector<record<traits>>& output)
+    {
+        if ((payload.size() != header.payload_bytes) || (header.records > payload.size() / segment_header::min_record_bytes) ||
+            (codec::hash_bytes(std::as_bytes(payload), header.seed()) != header.checksum))
+            return false;
+
+        output.reserve(output.size() + header.records);
+        data::timestamp previous {};
+        for (std::uint32_t i {}; i < header.records; ++i)
+        {
+            const auto sensor = codec::read_varint(payload);
+            const auto delta = codec::read_signed_varint(payload);
+            const auto value = codec::read_signed_varint(payload);
+            if (!sensor || !delta || !value)
+                return false;
+
+            previous += *delta;
+            output.push_back(record<traits> {static_cast<data::sensor_id>(*sensor), previous,
+                                             static_cast<typename traits::storage_type>(*value)});
+        }
+
+        return payload.empty();
+    }
+
+} // namespace sensor::replication
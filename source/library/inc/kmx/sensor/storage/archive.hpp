@@ -0,0 +1,265 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/storage/archive.hpp
+/// @brief Defines the sensor archive file: a sorted series stored as compressed blocks, preceded
+/// by a zone map (time and value bounds per block) that can be used directly from a mapping.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/codec/scaled.hpp>
+    #include <kmx/sensor/codec/timestamp.hpp>
+    #include <kmx/sensor/data/series.hpp>
+    #include <kmx/sensor/storage/mapped_file.hpp>
+    #include <algorithm>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <filesystem>
+    #include <limits>
+    #include <optional>
+    #include <span>
+    #include <type_traits>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::storage
+{
+    /// @brief The zone map entry of one archive block.
+    struct zone
+    {
+        /// @brief The first timestamp of the block.
+        data::timestamp first;
+        /// @brief The last timestamp of the block.
+        data::timestamp last;
+        /// @brief The smallest raw scaled value of the block.
+        std::int64_t min;
+        /// @brief The largest raw scaled value of the block.
+        std::int64_t max;
+        /// @brief The offset of the block's encoded data from the start of the data region.
+        std::uint64_t offset;
+        /// @brief The length of the block's encoded data in bytes.
+        std::uint64_t length;
+        /// @brief The number of readings in the block.
+        std::uint64_t rows;
+    };
+
+    /// @brief The fixed header at the start of every archive file.
+    struct archive_header
+    {
+        static constexpr std::uint64_t expected_magic = 0x4B4D58534E534131u; // "KMXSNSA1"
+
+        std::uint64_t magic;
+        /// @brief sizeof(storage_type) of the archived sensor type.
+        std::uint32_t storage_bytes;
+        /// @brief 1 if the storage type is signed, 0 otherwise.
+        std::uint32_t storage_signed;
+        std::uint64_t rows;
+        std::uint64_t blocks;
+    };
+
+    /// @brief Builds an archive file from readings appended in time order.
+    /// @details Readings are buffered until a block is full; each block is compressed on the spot
+    ///          (timestamps with `codec::timestamp_column`, values with `codec::write_scaled`), so the
+    ///          builder only holds one uncompressed block at a time.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class archive_builder
+    {
+    public:
+        using storage_type = typename traits::storage_type;
+
+        /// @brief The default number of readings per block.
+        static constexpr std::size_t default_block_rows = 4096u;
+
+        /// @brief Constructor.
+        /// @param block_rows The number of readings per block.
+        explicit archive_builder(const std::size_t block_rows = default_block_rows): block_rows_ {block_rows}
+        {
+            block_.reserve(block_rows_);
+        }
+
+        /// @brief Appends a reading.
+        /// @return True if the reading was appended, false if it is out of order or out of range.
+        bool push_back(const data::timestamp time, const storage_type value)
+        {
+            if (block_.empty() && !zones_.empty() && (time < zones_.back().last))
+                return false;
+            if (!block_.push_back(time, value))
+                return false;
+            if (block_.size() >= block_rows_)
+                flush_block();
+            return true;
+        }
+
+        /// @brief Gets the number of readings appended so far.
+        [[nodiscard]] std::size_t rows() const noexcept { return rows_ + block_.size(); }
+
+        /// @brief Gets the number of encoded bytes produced so far.
+        [[nodiscard]] std::size_t bytes() const noexcept { return data_.size(); }
+
+        /// @brief Writes the archive file and resets the builder.
+        /// @param path The file to write; it appears atomically.
+        /// @return True on success, false on an I/O error.
+        bool finish(const std::filesystem::path& path)
+        {
+            flush_block();
+            const archive_header header {archive_header::expected_magic, sizeof(storage_type), std::is_signed_v<storage_type> ? 1u : 0u,
+                                         rows_, zones_.size()};
+            const bool ok = write_file(path, {std::as_bytes(std::span {&header, 1u}), std::as_bytes(std::span {zones_}),
+                                              std::as_bytes(std::span {data_})});
+            rows_ = 0u;
+            zones_.clear();
+            data_.clear();
+            return ok;
+        }
+
+    private:
+        void flush_block()
+        {
+            if (block_.empty())
+                return;
+
+            const auto values = block_.values();
+            const auto [lowest, highest] = std::ranges::minmax(values);
+            const std::size_t offset = data_.size();
+            codec::timestamp_column {block_.times(), block_.size()}.serialize(data_);
+            codec::write_scaled(values, data_);
+            zones_.push_back(zone {block_.times().front(), block_.times().back(), static_cast<std::int64_t>(lowest),
+                                   static_cast<std::int64_t>(highest), offset, data_.size() - offset, block_.size()});
+            rows_ += block_.size();
+            block_.clear();
+        }
+
+        std::size_t block_rows_;
+        std::size_t rows_ {};
+        data::series<traits> block_;
+        std::vector<zone> zones_;
+        std::vector<std::uint8_t> data_;
+    };
+
+    /// @brief Writes a whole series as an archive file.
+    /// @return True on success, false on an I/O error or unsorted input.
+    template <typename traits>
+    bool write_archive(const std::filesystem::path& path, const data::series<traits>& source,
+                       const std::size_t block_rows = archive_builder<traits>::default_block_rows)
+    {
+        archive_builder<traits> builder {block_rows};
+        for (std::size_t i {}; i < source.size(); ++i)
+            if (!builder.push_back(source[i].time, source[i].value))
+                return false;
+        return builder.finish(path);
+    }
+
+    /// @brief A read-only, memory-mapped archive file.
+    /// @details The header and zone map are used in place; blocks are decoded on demand, so
+    ///          time-range reads only touch the blocks whose zone overlaps the range.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class archive
+    {
+    public:
+        using storage_type = typename traits::storage_type;
+
+        /// @brief Opens and validates an archive file.
+        /// @return The archive, or an empty optional if the file is missing, corrupt or of another sensor type.
+        [[nodiscard]] static std::optional<archive> open(const std::filesystem::path& path) noexcept
+        {
+            auto file = mapped_file::open(path);
+            if (!file || (file->size() < sizeof(archive_header)))
+                return {};
+
+            archive result;
+            std::memcpy(&result.header_, file->bytes().data(), sizeof(archive_header));
+            const archive_header& header = result.header_;
+            const std::size_t zone_bytes = static_cast<std::size_t>(header.blocks) * sizeof(zone);
+            if ((header.magic != archive_header::expected_magic) || (header.storage_bytes != sizeof(storage_type)) ||
+                (header.storage_signed != (std::is_signed_v<storage_type> ? 1u : 0u)) ||
+                (header.blocks > (file->size() - sizeof(archive_header)) / sizeof(zone)))
+                return {};
+
+            result.file_ = std::move(*file);
+            result.zones_ = {reinterpret_cast<const zone*>(result.file_.bytes().data() + sizeof(archive_header)),
+                             static_cast<std::size_t>(header.blocks)};
+            result.data_ = result.file_.bytes().subspan(sizeof(archive_header) + zone_bytes);
+            for (const zone& item: result.zones_)
+                if ((item.offset > result.data_.size()) || (item.length > result.data_.size() - item.offset))
+                    return {};
+            return result;
+        }
+
+        /// @brief Gets the number of readings in the archive.
+        [[nodiscard]] std::size_t rows() const noexcept { return static_cast<std::size_t>(header_.rows); }
+
+        /// @brief Gets the zone map, one entry per block.
+        [[nodiscard]] std::span<const zone> zones() const noexcept { return zones_; }
+
+        /// @brief Gets the size of the archive file in bytes.
+        [[nodiscard]] std::size_t bytes() const noexcept { return file_.size(); }
+
+        /// @brief Gets the first timestamp in the archive, if it is not empty.
+        [[nodiscard]] std::optional<data::timestamp> first() const noexcept
+        {
+            if (zones_.empty())
+                return {};
+            return zones_.front().first;
+        }
+
+        /// @brief Gets the last timestamp in the archive, if it is not empty.
+        [[nodiscard]] std::optional<data::timestamp> last() const noexcept
+        {
+            if (zones_.empty())
+                return {};
+            return zones_.back().last;
+        }
+
+        /// @brief Decodes one block.
+        /// @param index The block index.
+        /// @param times The vector the timestamps are appended to.
+        /// @param values The vector the raw scaled values are appended to.
+        /// @return True on success, false if the block is corrupt or out of range.
+        bool read_block(const std::size_t index, std::vector<data::timestamp>& times, std::vector<storage_type>& values) const
+        {
+            if (index >= zones_.size())
+                return false;
+
+            const zone& item = zones_[index];
+            auto input = std::span<const std::uint8_t> {reinterpret_cast<const std::uint8_t*>(data_.data() + item.offset),
+                                                        static_cast<std::size_t>(item.length)};
+            const auto column = codec::timestamp_column::deserialize(input);
+            return column && (column->size() == item.rows) && column->decode(times) &&
+                   codec::read_scaled(input, static_cast<std::size_t>(item.rows), values);
+        }
+
+        /// @brief Reads the readings taken in [from, to), decoding only the blocks whose zone overlaps the range.
+        /// @param output The series the readings are appended to.
+        /// @return True on success, false if a block is corrupt.
+        bool read(data::series<traits>& output, const data::timestamp from = std::numeric_limits<data::timestamp>::min(),
+                  const data::timestamp to = std::numeric_limits<data::timestamp>::max()) const
+        {
+            std::vector<data::timestamp> times;
+            std::vector<storage_type> values;
+            for (std::size_t index {}; index < zones_.size(); ++index)
+            {
+                if ((zones_[index].last < from) || (zones_[index].first >= to))
+                    continue;
+
+                times.clear();
+                values.clear();
+                if (!read_block(index, times, values))
+                    return false;
+                for (std::size_t i {}; i < times.size(); ++i)
+                    if ((times[i] >= from) && (times[i] < to))
+                        output.push_back(times[i], values[i]);
+            }
+
+            return true;
+        }
+
+    private:
+        archive() noexcept = default;
+
+        mapped_file file_;
+        archive_header header_ {};
+        std::span<const zone> zones_;
+        std::span<const std::byte> data_;
+    };
+
+} // namespace sensor::storage
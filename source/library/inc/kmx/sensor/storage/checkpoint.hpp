@@ -0,0 +1,335 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/storage/checkpoint.hpp
+/// @brief Defines snapshots of in-memory operator state as a single memory-mappable file of named,
+/// aligned raw arrays, written asynchronously and used in place on restore.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/pool.hpp>
+    #include <kmx/sensor/storage/mapped_file.hpp>
+    #include <algorithm>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <filesystem>
+    #include <future>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <tuple>
+    #include <type_traits>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::storage
+{
+    /// @brief The fixed header at the start of every checkpoint file.
+    struct checkpoint_header
+    {
+        static constexpr std::uint64_t expected_magic = 0x4B4D58534E534B31u; // "KMXSNSK1"
+
+        std::uint64_t magic;
+        std::uint64_t sections;
+        /// @brief The offset of the data region from the start of the file.
+        std::uint64_t data_offset;
+        std::uint64_t reserved;
+    };
+
+    /// @brief The directory entry of one named array in a checkpoint file.
+    struct checkpoint_section
+    {
+        /// @brief The maximal length of a section name.
+        static constexpr std::size_t max_name = 40u;
+
+        char name[max_name];
+        /// @brief The offset of the array from the start of the data region.
+        std::uint64_t offset;
+        /// @brief The size of the array in bytes.
+        std::uint64_t bytes;
+        /// @brief sizeof() of one array element, checked on restore.
+        std::uint32_t element_size;
+        /// @brief alignof() of one array element, checked on restore.
+        std::uint32_t element_alignment;
+    };
+
+    /// @brief Collects a consistent snapshot of operator state and writes it as a checkpoint file.
+    /// @details `add` copies the given arrays immediately, so the owning operators may keep running
+    ///          while the snapshot is written in the background with `write_async`. Every array starts
+    ///          on a 64-byte boundary, so a restored array can be used in place from the mapping.
+    class checkpoint_writer
+    {
+    public:
+        /// @brief The alignment of every array in the file.
+        static constexpr std::size_t alignment = 64u;
+
+        /// @brief Adds a named array of trivially copyable elements to the snapshot.
+        /// @param name The section name (at most `checkpoint_section::max_name` characters, unique).
+        /// @param items The elements to copy.
+        /// @return True if the section was added, false if the name is too long or already used.
+        template <typename item>
+            requires std::is_trivially_copyable_v<item>
+        bool add(const std::string_view name, const std::span<const item> items)
+        {
+            static_assert(alignof(item) <= alignment, "Over-aligned types are not supported.");
+            if (name.empty() || (name.size() > checkpoint_section::max_name) || find(name))
+                return false;
+
+            checkpoint_section section {};
+            std::ranges::copy(name, section.name);
+            section.offset = (data_.size() + alignment - 1u) / alignment * alignment;
+            section.bytes = items.size_bytes();
+            section.element_size = sizeof(item);
+            section.element_alignment = alignof(item);
+            sections_.push_back(section);
+
+            data_.resize(static_cast<std::size_t>(section.offset + section.bytes));
+            if (!items.empty())
+                std::memcpy(data_.data() + section.offset, items.data(), items.size_bytes());
+            return true;
+        }
+
+        /// @brief Adds a single trivially copyable value to the snapshot.
+        template <typename item>
+            requires std::is_trivially_copyable_v<item>
+        bool add_value(const std::string_view name, const item& value)
+        {
+            return add(name, std::span<const item> {&value, 1u});
+        }
+
+        /// @brief Gets the size of the snapshot file in bytes.
+        [[nodiscard]] std::size_t bytes() const noexcept { return data_offset() + data_.size(); }
+
+        /// @brief Writes the snapshot file atomically.
+        /// @return True on success, false on an I/O error.
+        bool write(const std::filesystem::path& path) const
+        {
+            const checkpoint_header header {checkpoint_header::expected_magic, sections_.size(), data_offset(), 0u};
+            const std::vector<std::byte> padding(data_offset() - sizeof(header) - (sections_.size() * sizeof(checkpoint_section)));
+            return write_file(path, {std::as_bytes(std::span {&header, 1u}), std::as_bytes(std::span {sections_}), std::span {padding},
+                                     std::span<const std::byte> {data_}});
+        }
+
+        /// @brief Writes the snapshot file on a background thread.
+        /// @details The writer's buffers move into the task, so the writer is consumed.
+        /// @return A future yielding the result of `write`.
+        [[nodiscard]] std::future<bool> write_async(std::filesystem::path path) &&
+        {
+            return std::async(std::launch::async, [snapshot = std::move(*this), path = std::move(path)] { return snapshot.write(path); });
+        }
+
+    private:
+        [[nodiscard]] bool find(const std::string_view name) const noexcept
+        {
+            return std::ranges::any_of(sections_,
+                                       [name](const checkpoint_section& item)
+                                       {
+                                           const std::size_t length = ::strnlen(item.name, checkpoint_section::max_name);
+                                           return std::string_view {item.name, length} == name;
+                                       });
+        }
+
+        [[nodiscard]] std::size_t data_offset() const noexcept
+        {
+            const std::size_t directory_end = sizeof(checkpoint_header) + (sections_.size() * sizeof(checkpoint_section));
+            return (directory_end + alignment - 1u) / alignment * alignment;
+        }
+
+        std::vector<checkpoint_section> sections_;
+        std::vector<std::byte> data_;
+    };
+
+    /// @brief A memory-mapped checkpoint file.
+    /// @details Restoring does not parse anything: `section` validates one directory entry and returns a
+    ///          span pointing straight into the mapping, so loading costs O(size) page faults at most.
+    class checkpoint
+    {
+    public:
+        /// @brief Opens and validates a checkpoint file.
+        /// @return The checkpoint, or an empty optional if the file is missing or corrupt.
+        [[nodiscard]] static std::optional<checkpoint> open(const std::filesystem::path& path) noexcept
+        {
+            auto file = mapped_file::open(path);
+            if (!file || (file->size() < sizeof(checkpoint_header)))
+                return {};
+
+            checkpoint_header header;
+            std::memcpy(&header, file->bytes().data(), sizeof(header));
+            const std::size_t available = (file->size() - sizeof(header)) / sizeof(checkpoint_section);
+            if ((header.magic != checkpoint_header::expected_magic) || (header.sections > available) ||
+                (header.data_offset > file->size()) || (header.data_offset % checkpoint_writer::alignment != 0u))
+                return {};
+
+            checkpoint result;
+            result.file_ = std::move(*file);
+            result.sections_ = {reinterpret_cast<const checkpoint_section*>(result.file_.bytes().data() + sizeof(header)),
+                                static_cast<std::size_t>(header.sections)};
+            result.data_ = result.file_.bytes().subspan(static_cast<std::size_t>(header.data_offset));
+            return result;
+        }
+
+        /// @brief Gets a named array.
+        /// @return A span over the mapped array, or an empty optional if the section is missing or was
+        ///         written with a different element type layout.
+        template <typename item>
+            requires std::is_trivially_copyable_v<item>
+        [[nodiscard]] std::optional<std::span<const item>> section(const std::string_view name) const noexcept
+        {
+            for (const checkpoint_section& entry: sections_)
+            {
+                if (std::string_view {entry.name, ::strnlen(entry.name, checkpoint_section::max_name)} != name)
+                    continue;
+                if ((entry.element_size != sizeof(item)) || (entry.element_alignment != alignof(item)) ||
+                    (entry.offset % alignof(item) != 0u) || (entry.bytes % sizeof(item) != 0u) || (entry.offset > data_.size()) ||
+                    (entry.bytes > data_.size() - entry.offset))
+                    return {};
+                return std::span<const item> {reinterpret_cast<const item*>(data_.data() + entry.offset),
+                                              static_cast<std::size_t>(entry.bytes / sizeof(item))};
+            }
+
+            return {};
+        }
+
+        /// @brief Gets a single named value written with `checkpoint_writer::add_value`.
+        template <typename item>
+            requires std::is_trivially_copyable_v<item>
+        [[nodiscard]] std::optional<item> value(const std::string_view name) const noexcept
+        {
+            const auto items = section<item>(name);
+            if (!items || (items->size() != 1u))
+                return {};
+            return items->front();
+        }
+
+        /// @brief Gets the size of the checkpoint file in bytes.
+        [[nodiscard]] std::size_t bytes() const noexcept { return file_.size(); }
+
+    private:
+        checkpoint() noexcept = default;
+
+        mapped_file file_;
+        std::span<const checkpoint_section> sections_;
+        std::span<const std::byte> data_;
+    };
+
+    /// @brief Gets the name of a section that belongs to the one called `name`, e.g. `"pool.sensors"`.
+    [[nodiscard]] inline std::string section_name(const std::string_view name, const std::string_view suffix)
+    {
+        std::string result {name};
+        result += '.';
+        result += suffix;
+        return result;
+    }
+
+    /// @brief Adds the state of a view (e.g. a `query::continuous_query`) to a checkpoint snapshot as one raw array.
+    /// @details A view whose state has a part that is not per entry (e.g. `monitoring::staleness_monitor`)
+    ///          provides it as a `snapshot_header` through `snapshot_head()`; it is added as the single value
+    ///          `<name>.header`.
+    /// @param writer The snapshot to add to.
+    /// @param name The section name of the view.
+    /// @param source The view; it provides its state through `snapshot()`.
+    /// @return True if the section was added.
+    template <typename view>
+        requires std::is_trivially_copyable_v<typename view::snapshot_entry>
+    bool save(checkpoint_writer& writer, const std::string_view name, const view& source)
+    {
+        if constexpr (requires { typename view::snapshot_header; })
+        {
+            static_assert(std::is_trivially_copyable_v<typename view::snapshot_header>);
+            if (!writer.add_value(section_name(name, "header"), source.snapshot_head()))
+                return false;
+        }
+
+        const auto entries = source.snapshot();
+        return writer.add(name, std::span<const typename view::snapshot_entry> {entries});
+    }
+
+    /// @brief Replaces the state of a view with the one saved in a checkpoint by `save`.
+    /// @details The view must have been constructed with the same configuration (e.g. window width and
+    ///          prototype) as the one that was saved.
+    /// @param source The checkpoint to restore from.
+    /// @param name The section name of the view.
+    /// @param target The view; it takes the state through `load()`.
+    /// @return True if the section was found and restored, false otherwise (the view is unchanged).
+    template <typename view>
+        requires std::is_trivially_copyable_v<typename view::snapshot_entry>
+    bool restore(const checkpoint& source, const std::string_view name, view& target)
+    {
+        const auto entries = source.section<typename view::snapshot_entry>(name);
+        if (!entries)
+            return false;
+
+        if constexpr (requires { typename view::snapshot_header; })
+        {
+            const auto header = source.value<typename view::snapshot_header>(section_name(name, "header"));
+            if (!header)
+                return false;
+            target.load(*header, *entries);
+        }
+        else
+            target.load(*entries);
+        return true;
+    }
+
+    /// @brief Adds an array of trivially copyable operator state (e.g. `query::time_integral` per sensor)
+    ///        to a checkpoint snapshot.
+    /// @return True if the section was added.
+    template <typename item>
+        requires std::is_trivially_copyable_v<item>
+    bool save(checkpoint_writer& writer, const std::string_view name, const std::vector<item>& source)
+    {
+        return writer.add(name, std::span<const item> {source});
+    }
+
+    /// @brief Replaces an array of operator state with the one saved in a checkpoint by `save`.
+    /// @return True if the section was found and restored, false otherwise (the array is unchanged).
+    template <typename item>
+        requires std::is_trivially_copyable_v<item>
+    bool restore(const checkpoint& source, const std::string_view name, std::vector<item>& target)
+    {
+        const auto items = source.section<item>(name);
+        if (!items)
+            return false;
+
+        target.assign(items->begin(), items->end());
+        return true;
+    }
+
+    /// @brief Adds a state pool to a checkpoint snapshot.
+    /// @details The pool is saved as the raw arrays `<name>.generations`, `<name>.sensors` and one
+    ///          `<name>.<i>` per field, so `name` must leave room for these suffixes.
+    /// @return True if all sections were added.
+    template <typename... fields>
+        requires (std::is_trivially_copyable_v<fields> && ...)
+    bool save(checkpoint_writer& writer, const std::string_view name, const data::state_pool<fields...>& source)
+    {
+        if (!writer.add(section_name(name, "generations"), source.generations()) ||
+            !writer.add(section_name(name, "sensors"), source.sensors()))
+            return false;
+
+        return [&]<std::size_t... i>(std::index_sequence<i...>)
+        {
+            return (writer.add(section_name(name, std::to_string(i)), source.template column<i>()) && ...);
+        }(std::index_sequence_for<fields...> {});
+    }
+
+    /// @brief Replaces the state of a pool with the one saved in a checkpoint by `save`.
+    /// @details Handles issued before the pool was saved refer to the restored state.
+    /// @return True if all sections were found and restored, false otherwise (the pool is unchanged).
+    template <typename... fields>
+        requires (std::is_trivially_copyable_v<fields> && ...)
+    bool restore(const checkpoint& source, const std::string_view name, data::state_pool<fields...>& target)
+    {
+        const auto generations = source.section<std::uint32_t>(section_name(name, "generations"));
+        const auto sensors = source.section<data::sensor_id>(section_name(name, "sensors"));
+        if (!generations || !sensors)
+            return false;
+
+        return [&]<std::size_t... i>(std::index_sequence<i...>)
+        {
+            const auto columns = std::tuple {source.section<fields>(section_name(name, std::to_string(i)))...};
+            return (std::get<i>(columns).has_value() && ...) && target.load(*generations, *sensors, *std::get<i>(columns)...);
+        }(std::index_sequence_for<fields...> {});
+    }
+
+} // namespace sensor::storage
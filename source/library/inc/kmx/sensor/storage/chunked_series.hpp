@@ -0,0 +1,284 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/storage/chunked_series.hpp
+/// @brief Defines a series stored as immutable, versioned chunks that are sealed as the open head
+/// fills up and transparently spilled to memory-mapped files under memory pressure.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/series.hpp>
+    #include <kmx/sensor/storage/governor.hpp>
+    #include <kmx/sensor/storage/mapped_file.hpp>
+    #include <algorithm>
+    #include <cerrno>
+    #include <charconv>
+    #include <cstddef>
+    #include <cstdint>
+    #include <filesystem>
+    #include <mutex>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <system_error>
+    #include <vector>
+    #include <signal.h>
+    #include <unistd.h>
+#endif
+
+namespace kmx::sensor::storage
+{
+    /// @brief A read-only view of one sealed chunk, valid until the next spill or mutation of its series.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    struct chunk_view
+    {
+        using storage_type = typename traits::storage_type;
+
+        /// @brief The process-unique version id assigned when the chunk was sealed.
+        std::uint64_t version;
+        /// @brief The timestamp column of the chunk.
+        std::span<const data::timestamp> times;
+        /// @brief The raw scaled value column of the chunk.
+        std::span<const storage_type> values;
+        /// @brief True if the chunk lives in memory, false if it is served from its spill file.
+        bool resident;
+    };
+
+    /// @brief Removes the spill files left in a directory by processes that are no longer running.
+    /// @details Spill files are named `<pid>-<series>-<version>.chunk`; a file whose process id belongs to
+    ///          no running process was left behind by a run that crashed before its series were destroyed.
+    /// @param directory The spill directory.
+    /// @return The number of removed files.
+    inline std::size_t remove_stale_spill_files(const std::filesystem::path& directory)
+    {
+        std::size_t removed {};
+        std::error_code error;
+        for (std::filesystem::directory_iterator it {directory, error}, end; !error && (it != end); it.increment(error))
+        {
+            const std::string name = it->path().filename().string();
+            ::pid_t pid {};
+            const auto [next, parsed] = std::from_chars(name.data(), name.data() + name.size(), pid);
+            if (!name.ends_with(".chunk") || (parsed != std::errc {}) || (*next != '-') || (pid <= 0) || (pid == ::getpid()))
+                continue;
+            if ((::kill(pid, 0) == 0) || (errno != ESRCH))
+                continue;
+
+            std::error_code remove_error;
+            if (std::filesystem::remove(it->path(), remove_error))
+                ++removed;
+        }
+
+        return removed;
+    }
+
+    /// @brief Issues a process-unique spill file prefix for a series, `<pid>-<series>`.
+    /// @details The first series of the process that uses a directory removes the stale files in it first.
+    /// @param directory The spill directory of the series.
+    [[nodiscard]] inline std::string spill_prefix(const std::filesystem::path& directory)
+    {
+        static std::mutex mutex;
+        static std::vector<std::filesystem::path> swept;
+        static std::uint64_t last_series {};
+
+        const std::lock_guard lock {mutex};
+        std::error_code error;
+        const std::filesystem::path canonical = std::filesystem::weakly_canonical(directory, error);
+        if (std::ranges::find(swept, canonical) == swept.end())
+        {
+            swept.push_back(canonical);
+            (void) remove_stale_spill_files(directory);
+        }
+
+        return std::to_string(::getpid()) + '-' + std::to_string(++last_series);
+    }
+
+    /// @brief A time-ordered series split into sealed chunks of `chunk_rows` readings plus an open head.
+    /// @details Sealed chunks are immutable and charged to a `memory_governor`. When the governor's budget
+    ///          is exceeded, the least recently accessed resident chunk is written as raw columns to a file
+    ///          in the spill directory, its memory is released, and later accesses read it through a
+    ///          read-only memory mapping. Readers see the same `chunk_view` either way.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class chunked_series final: public memory_governor::spillable
+    {
+    public:
+        using traits_type = traits;
+        using storage_type = typename traits::storage_type;
+        using view_type = chunk_view<traits>;
+
+        /// @brief The default number of readings per chunk.
+        static constexpr std::size_t default_chunk_rows = 4096u;
+
+        /// @brief Constructor.
+        /// @param governor The memory governor to account to; must outlive the series.
+        /// @param spill_directory An existing directory for spill files; it may be shared by several series and
+        ///                        processes. Files left in it by crashed runs are removed by the first series of
+        ///                        the process that uses it.
+        /// @param chunk_rows The number of readings per sealed chunk.
+        chunked_series(memory_governor& governor, std::filesystem::path spill_directory, const std::size_t chunk_rows = default_chunk_rows):
+            governor_ {governor},
+            spill_directory_ {std::move(spill_directory)},
+            chunk_rows_ {chunk_rows},
+            prefix_ {spill_prefix(spill_directory_)}
+        {
+            head_.reserve(chunk_rows_);
+            governor_.charge(chunk_rows_ * row_bytes);
+            governor_.attach(*this);
+        }
+
+        chunked_series(const chunked_series&) = delete;
+        chunked_series& operator=(const chunked_series&) = delete;
+
+        ~chunked_series() noexcept
+        {
+            governor_.detach(*this);
+            governor_.release(chunk_rows_ * row_bytes);
+            for (const chunk& item: chunks_)
+            {
+                if (item.file)
+                {
+                    std::error_code error;
+                    std::filesystem::remove(file_path(item.version), error);
+                }
+                else
+                    governor_.release(item.times.size() * row_bytes);
+            }
+        }
+
+        /// @brief Appends a raw scaled reading, sealing the head when it is full.
+        /// @return True if the reading was appended, false if it is out of order or out of range.
+        bool push_back(const data::timestamp time, const storage_type value)
+        {
+            if (!chunks_.empty() && head_.empty() && (time < chunks_.back().last))
+                return false;
+            if (!head_.push_back(time, value))
+                return false;
+            if (head_.size() >= chunk_rows_)
+                seal();
+            return true;
+        }
+
+        /// @brief Seals the open head into an immutable chunk and enforces the memory budget.
+        void seal()
+        {
+            if (head_.empty())
+                return;
+
+            chunk item;
+            item.version = governor_.next_id();
+            item.last_access = governor_.tick();
+            item.last = head_.times().back();
+            item.times.assign(head_.times().begin(), head_.times().end());
+            item.values.assign(head_.values().begin(), head_.values().end());
+            governor_.charge(item.times.size() * row_bytes);
+            chunks_.push_back(std::move(item));
+            head_.clear();
+            governor_.enforce();
+        }
+
+        /// @brief Gets the number of sealed chunks.
+        [[nodiscard]] std::size_t chunks() const noexcept { return chunks_.size(); }
+
+        /// @brief Gets a sealed chunk and marks it as recently used.
+        /// @return A view of the chunk, or an empty optional if it is out of range or its file is unreadable.
+        [[nodiscard]] std::optional<view_type> chunk_at(const std::size_t index)
+        {
+            if (index >= chunks_.size())
+                return {};
+
+            chunk& item = chunks_[index];
+            item.last_access = governor_.tick();
+            if (!item.file)
+                return view_type {item.version, item.times, item.values, true};
+
+            const auto bytes = item.file->bytes();
+            const std::size_t rows = (bytes.size() - header_bytes) / row_bytes;
+            const auto* const times = reinterpret_cast<const data::timestamp*>(bytes.data() + header_bytes);
+            const auto* const values = reinterpret_cast<const storage_type*>(times + rows);
+            return view_type {item.version, {times, rows}, {values, rows}, false};
+        }
+
+        /// @brief Gets the version id of a sealed chunk without touching it.
+        [[nodiscard]] std::uint64_t version(const std::size_t index) const noexcept { return chunks_[index].version; }
+
+        /// @brief Gets the open, unsealed head of the series.
+        [[nodiscard]] const data::series<traits>& head() const noexcept { return head_; }
+
+        /// @brief Gets the total number of readings, sealed and open.
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            std::size_t total = head_.size();
+            for (const chunk& item: chunks_)
+                total += item.file ? ((item.file->size() - header_bytes) / row_bytes) : item.times.size();
+            return total;
+        }
+
+        /// @brief Gets the number of chunks currently served from spill files.
+        [[nodiscard]] std::size_t spilled_chunks() const noexcept
+        {
+            return static_cast<std::size_t>(std::ranges::count_if(chunks_, [](const chunk& item) { return item.file.has_value(); }));
+        }
+
+        [[nodiscard]] std::optional<std::uint64_t> coldest_access() const noexcept override
+        {
+            std::optional<std::uint64_t> result;
+            for (const chunk& item: chunks_)
+                if (!item.file && (!result || (item.last_access < *result)))
+                    result = item.last_access;
+            return result;
+        }
+
+        std::size_t spill_coldest() override
+        {
+            chunk* coldest {};
+            for (chunk& item: chunks_)
+                if (!item.file && ((coldest == nullptr) || (item.last_access < coldest->last_access)))
+                    coldest = &item;
+            if (coldest == nullptr)
+                return 0u;
+
+            const std::size_t rows = coldest->times.size();
+            const std::uint64_t header[2] = {magic, rows};
+            const auto path = file_path(coldest->version);
+            if (!write_file(path, {std::as_bytes(std::span {header}), std::as_bytes(std::span {coldest->times}),
+                                   std::as_bytes(std::span {coldest->values})}))
+                return 0u;
+
+            auto file = mapped_file::open(path);
+            if (!file || (file->size() != header_bytes + (rows * row_bytes)))
+                return 0u;
+
+            coldest->file = std::move(file);
+            std::vector<data::timestamp> {}.swap(coldest->times);
+            std::vector<storage_type> {}.swap(coldest->values);
+            governor_.release(rows * row_bytes);
+            return rows * row_bytes;
+        }
+
+    private:
+        static constexpr std::uint64_t magic = 0x4B4D58534E534331u; // "KMXSNSC1"
+        static constexpr std::size_t header_bytes = 2u * sizeof(std::uint64_t);
+        static constexpr std::size_t row_bytes = sizeof(data::timestamp) + sizeof(storage_type);
+
+        struct chunk
+        {
+            std::uint64_t version {};
+            std::uint64_t last_access {};
+            data::timestamp last {};
+            std::vector<data::timestamp> times;
+            std::vector<storage_type> values;
+            std::optional<mapped_file> file;
+        };
+
+        [[nodiscard]] std::filesystem::path file_path(const std::uint64_t version) const
+        {
+            return spill_directory_ / (prefix_ + '-' + std::to_string(version) + ".chunk");
+        }
+
+        memory_governor& governor_;
+        std::filesystem::path spill_directory_;
+        std::size_t chunk_rows_;
+        std::string prefix_;
+        data::series<traits> head_;
+        std::vector<chunk> chunks_;
+    };
+
+} // namespace sensor::storage
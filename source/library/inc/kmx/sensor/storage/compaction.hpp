@@ -0,0 +1,347 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/storage/compaction.hpp
+/// @brief Defines size-tiered, rate-limited compaction of a directory of small archive files into
+/// larger sorted ones, using a k-way merge over the decoded columns.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/storage/archive.hpp>
+    #include <algorithm>
+    #include <atomic>
+    #include <chrono>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <filesystem>
+    #include <functional>
+    #include <limits>
+    #include <mutex>
+    #include <optional>
+    #include <queue>
+    #include <stop_token>
+    #include <string>
+    #include <string_view>
+    #include <thread>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::storage
+{
+    /// @brief A token bucket limiting throughput in bytes per second.
+    class rate_limiter
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        /// @brief Constructor.
+        /// @param bytes_per_second The sustained rate; 0 disables limiting.
+        /// @param burst The number of bytes that may be consumed at once after an idle period.
+        explicit rate_limiter(const std::size_t bytes_per_second, const std::size_t burst = 1024u * 1024u) noexcept:
+            rate_ {static_cast<double>(bytes_per_second)}, burst_ {static_cast<double>(burst)}, tokens_ {burst_}, refilled_ {clock::now()}
+        {
+        }
+
+        /// @brief Consumes tokens for a number of bytes, sleeping first if the bucket runs dry.
+        /// @param bytes The number of bytes.
+        /// @param stop Cuts the sleep short once a stop is requested.
+        /// @return False if a stop was requested, true otherwise.
+        bool acquire(const std::size_t bytes, const std::stop_token stop = {})
+        {
+            if (rate_ <= 0.0)
+                return !stop.stop_requested();
+
+            const auto now = clock::now();
+            tokens_ = std::min(burst_, tokens_ + (std::chrono::duration<double>(now - refilled_).count() * rate_));
+            refilled_ = now;
+            tokens_ -= static_cast<double>(bytes);
+            if (tokens_ < 0.0)
+            {
+                // Sleeps in short slices, so that a stop request is noticed promptly.
+                const auto until = now + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(-tokens_ / rate_));
+                for (auto at = clock::now(); (at < until) && !stop.stop_requested(); at = clock::now())
+                    std::this_thread::sleep_for(std::min<clock::duration>(until - at, stop_poll));
+            }
+
+            return !stop.stop_requested();
+        }
+
+    private:
+        static constexpr std::chrono::milliseconds stop_poll {50};
+
+        double rate_;
+        double burst_;
+        double tokens_;
+        clock::time_point refilled_;
+    };
+
+    /// @brief The tuning parameters of archive compaction.
+    struct compaction_policy
+    {
+        /// @brief The number of files of one tier merged together.
+        std::size_t fanout = 4u;
+        /// @brief Files with fewer than `base_rows * fanout` readings form tier 0; each further tier is `fanout` times larger.
+        std::size_t base_rows = 4096u;
+        /// @brief The number of readings per block of the merged files.
+        std::size_t block_rows = 4096u;
+        /// @brief The maximum rate at which input archives are read, in bytes per second (0 is unlimited).
+        std::size_t bytes_per_second = 8u * 1024u * 1024u;
+    };
+
+    /// @brief Merges archive files of one sensor series into larger ones.
+    /// @details The directory holds `.kar` archive files of one series, e.g. one per gateway flush. Files are
+    ///          grouped into size tiers; once a tier holds `fanout` files, they are merged with a k-way merge
+    ///          over their decoded blocks into one file of the next tier, written atomically with a rebuilt
+    ///          zone map and synced to storage, after which the inputs are removed. Readers that still map an
+    ///          input are unaffected.
+    ///          The merge reads at most `bytes_per_second`, so it does not starve ingestion of I/O.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class compactor
+    {
+    public:
+        using storage_type = typename traits::storage_type;
+
+        /// @brief The file extension of archive files.
+        static constexpr std::string_view extension = ".kar";
+
+        /// @brief Constructor.
+        /// @param directory The directory holding the archive files.
+        /// @param policy The compaction parameters; a fanout below 2 is raised to 2, and row counts below 1 to 1.
+        explicit compactor(std::filesystem::path directory, const compaction_policy policy = {}):
+            directory_ {std::move(directory)}, policy_ {validated(policy)}, limiter_ {policy.bytes_per_second}
+        {
+        }
+
+        /// @brief Performs at most one merge.
+        /// @param stop Abandons the merge once a stop is requested.
+        /// @return The merged file, or an empty optional if no tier is full or the merge failed or was stopped.
+        std::optional<std::filesystem::path> compact_once(const std::stop_token stop = {})
+        {
+            struct candidate
+            {
+                std::filesystem::path path;
+                data::timestamp first;
+                std::size_t tier;
+            };
+
+            std::vector<candidate> candidates;
+            std::error_code error;
+            for (const auto& entry: std::filesystem::directory_iterator {directory_, error})
+            {
+                if (!entry.is_regular_file() || (entry.path().extension() != extension))
+                    continue;
+                if (const auto file = archive<traits>::open(entry.path()); file && file->first())
+                    candidates.push_back(candidate {entry.path(), *file->first(), tier_of(file->rows())});
+            }
+
+            std::ranges::sort(candidates, {}, [](const candidate& item) { return std::pair {item.tier, item.first}; });
+            for (auto begin = candidates.begin(); begin != candidates.end();)
+            {
+                const std::size_t tier = begin->tier;
+                const auto end = std::ranges::find_if(begin, candidates.end(), [tier](const candidate& item) { return item.tier != tier; });
+                if (static_cast<std::size_t>(end - begin) >= policy_.fanout)
+                {
+                    std::vector<std::filesystem::path> inputs;
+                    for (auto it = begin; it != begin + static_cast<std::ptrdiff_t>(policy_.fanout); ++it)
+                        inputs.push_back(it->path);
+                    return merge(inputs, stop);
+                }
+
+                begin = end;
+            }
+
+            return {};
+        }
+
+        /// @brief Merges until no tier is full or a stop is requested.
+        /// @param stop Ends the pass (abandoning the merge in progress) once a stop is requested.
+        /// @return The number of merges performed.
+        std::size_t compact_all(const std::stop_token stop = {})
+        {
+            std::size_t merges {};
+            while (!stop.stop_requested() && compact_once(stop))
+                ++merges;
+            return merges;
+        }
+
+        /// @brief Merges archive files into one new file in the directory and removes the inputs.
+        /// @details The merged file is synced to storage (see `write_file`) before any input is removed, so a
+        ///          crash never loses readings. A crash between the two steps leaves the merged file next to
+        ///          some of its inputs, i.e. their readings twice: readers of the directory must tolerate, or
+        ///          drop, readings equal in time and value found in more than one file.
+        /// @param inputs The archive files to merge.
+        /// @param stop Abandons the merge once a stop is requested; nothing is written and the inputs stay.
+        /// @return The merged file, or an empty optional if an input is unreadable, the output cannot be written
+        ///         or the merge was stopped.
+        std::optional<std::filesystem::path> merge(const std::span<const std::filesystem::path> inputs, const std::stop_token stop = {})
+        {
+            std::vector<cursor> cursors;
+            cursors.reserve(inputs.size());
+            for (const auto& path: inputs)
+            {
+                auto file = archive<traits>::open(path);
+                if (!file)
+                    return {};
+                cursors.push_back(cursor {std::move(*file)});
+                if (!cursors.back().advance_block(limiter_, stop))
+                    return {};
+            }
+
+            // Min-heap on (timestamp, input index): equal timestamps keep the inputs' order.
+            using head = std::pair<data::timestamp, std::size_t>;
+            std::priority_queue<head, std::vector<head>, std::greater<head>> heads;
+            for (std::size_t i {}; i < cursors.size(); ++i)
+                if (!cursors[i].exhausted())
+                    heads.emplace(cursors[i].time(), i);
+
+            archive_builder<traits> builder {policy_.block_rows};
+            while (!heads.empty())
+            {
+                const std::size_t index = heads.top().second;
+                heads.pop();
+                cursor& input = cursors[index];
+                builder.push_back(input.time(), input.value());
+                if (!input.next(limiter_, stop))
+                    return {};
+                if (!input.exhausted())
+                    heads.emplace(input.time(), index);
+            }
+
+            // `finish` returns only once the merged file and its name are durable; only then may the inputs go.
+            const auto output = unique_path();
+            if (!builder.finish(output))
+                return {};
+
+            std::error_code error;
+            for (const auto& path: inputs)
+                std::filesystem::remove(path, error);
+            sync_directory(directory_);
+            return output;
+        }
+
+        /// @brief Gets the size tier of a file with a number of readings.
+        [[nodiscard]] std::size_t tier_of(const std::size_t rows) const noexcept
+        {
+            std::size_t tier {};
+            for (std::size_t limit = policy_.base_rows * policy_.fanout; rows >= limit; limit *= policy_.fanout)
+            {
+                ++tier;
+                if (limit > std::numeric_limits<std::size_t>::max() / policy_.fanout)
+                    break;
+            }
+
+            return tier;
+        }
+
+        /// @brief Gets the compacted directory.
+        [[nodiscard]] const std::filesystem::path& directory() const noexcept { return directory_; }
+
+    private:
+        /// @brief Reads one input archive block by block.
+        class cursor
+        {
+        public:
+            explicit cursor(archive<traits>&& file) noexcept: file_ {std::move(file)} {}
+
+            [[nodiscard]] bool exhausted() const noexcept { return position_ >= times_.size(); }
+            [[nodiscard]] data::timestamp time() const noexcept { return times_[position_]; }
+            [[nodiscard]] storage_type value() const noexcept { return values_[position_]; }
+
+            /// @brief Moves to the next reading; returns false if a block is corrupt or a stop was requested.
+            bool next(rate_limiter& limiter, const std::stop_token& stop)
+            {
+                return (++position_ < times_.size()) || advance_block(limiter, stop);
+            }
+
+            /// @brief Decodes the next block, if any; returns false if it is corrupt or a stop was requested.
+            bool advance_block(rate_limiter& limiter, const std::stop_token& stop)
+            {
+                times_.clear();
+                values_.clear();
+                position_ = 0u;
+                if (block_ >= file_.zones().size())
+                    return true;
+
+                return limiter.acquire(static_cast<std::size_t>(file_.zones()[block_].length), stop) &&
+                       file_.read_block(block_++, times_, values_);
+            }
+
+        private:
+            archive<traits> file_;
+            std::size_t block_ {};
+            std::size_t position_ {};
+            std::vector<data::timestamp> times_;
+            std::vector<storage_type> values_;
+        };
+
+        [[nodiscard]] static compaction_policy validated(compaction_policy policy) noexcept
+        {
+            policy.fanout = std::max<std::size_t>(policy.fanout, 2u);
+            policy.base_rows = std::max<std::size_t>(policy.base_rows, 1u);
+            policy.block_rows = std::max<std::size_t>(policy.block_rows, 1u);
+            return policy;
+        }
+
+        [[nodiscard]] std::filesystem::path unique_path()
+        {
+            const auto stamp = std::chrono::system_clock::now().time_since_epoch().count();
+            for (;; ++sequence_)
+            {
+                auto path = directory_ / ("compacted-" + std::to_string(stamp) + '-' + std::to_string(sequence_));
+                path += extension;
+                if (!std::filesystem::exists(path))
+                    return path;
+            }
+        }
+
+        std::filesystem::path directory_;
+        compaction_policy policy_;
+        rate_limiter limiter_;
+        std::uint64_t sequence_ {};
+    };
+
+    /// @brief Runs a compactor periodically on a background thread.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class background_compaction
+    {
+    public:
+        /// @brief Constructor. Starts the background thread.
+        /// @param directory The directory holding the archive files.
+        /// @param interval The pause between compaction passes.
+        /// @param policy The compaction parameters.
+        background_compaction(std::filesystem::path directory, const std::chrono::milliseconds interval,
+                              const compaction_policy policy = {}):
+            compactor_ {std::move(directory), policy}, thread_ {[this, interval](const std::stop_token stop) { run(stop, interval); }}
+        {
+        }
+
+        /// @brief Destructor. Stops the background thread, abandoning the merge in progress, if any.
+        ~background_compaction() noexcept
+        {
+            thread_.request_stop();
+            wake_.notify_all();
+        }
+
+        /// @brief Gets the number of merges performed so far.
+        [[nodiscard]] std::size_t merges() const noexcept { return merges_.load(); }
+
+    private:
+        void run(const std::stop_token stop, const std::chrono::milliseconds interval)
+        {
+            while (!stop.stop_requested())
+            {
+                merges_ += compactor_.compact_all(stop);
+                std::unique_lock lock {mutex_};
+                wake_.wait_for(lock, stop, interval, [] { return false; });
+            }
+        }
+
+        compactor<traits> compactor_;
+        std::atomic<std::size_t> merges_ {};
+        std::mutex mutex_;
+        std::condition_variable_any wake_;
+        std::jthread thread_;
+    };
+
+} // namespace sensor::storage
@@ -0,0 +1,113 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/storage/governor.hpp
+/// @brief Defines a memory governor that accounts the bytes held by columns, indexes and caches
+/// against a budget and spills the coldest sealed chunks when the budget is exceeded.
+#pragma once
+#ifndef PCH
+    #include <algorithm>
+    #include <cstddef>
+    #include <cstdint>
+    #include <optional>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::storage
+{
+    /// @brief Accounts memory use against a budget and enforces it by spilling cold data.
+    /// @details Holders of memory report it with `charge` and `release`; this is O(1) and safe to call
+    ///          from the ingest path. Holders that can move data out of memory (e.g. sealed chunks of a
+    ///          `chunked_series`) additionally attach themselves as `spillable`. When `enforce` finds the
+    ///          budget exceeded, it repeatedly spills the least recently accessed chunk among all
+    ///          attached spillables until the budget is met or nothing is left to spill.
+    ///          Not thread-safe; a governor is owned by the thread that owns the store.
+    class memory_governor
+    {
+    public:
+        /// @brief Interface of memory holders that can move their coldest data to disk.
+        class spillable
+        {
+        public:
+            /// @brief Gets the access tick of the coldest spillable data, if any is resident.
+            [[nodiscard]] virtual std::optional<std::uint64_t> coldest_access() const noexcept = 0;
+
+            /// @brief Spills the coldest resident data.
+            /// @return The number of bytes released from memory (0 if nothing could be spilled).
+            virtual std::size_t spill_coldest() = 0;
+
+        protected:
+            ~spillable() = default;
+        };
+
+        /// @brief Constructor.
+        /// @param budget The memory budget in bytes.
+        explicit memory_governor(const std::size_t budget) noexcept: budget_ {budget} {}
+
+        memory_governor(const memory_governor&) = delete;
+        memory_governor& operator=(const memory_governor&) = delete;
+
+        /// @brief Accounts newly allocated bytes.
+        void charge(const std::size_t bytes) noexcept { used_ += bytes; }
+
+        /// @brief Accounts released bytes.
+        void release(const std::size_t bytes) noexcept { used_ -= std::min(bytes, used_); }
+
+        /// @brief Attaches a spillable memory holder; it must detach itself before it is destroyed.
+        void attach(spillable& item) { spillables_.push_back(&item); }
+
+        /// @brief Detaches a spillable memory holder.
+        void detach(spillable& item) noexcept { std::erase(spillables_, &item); }
+
+        /// @brief Advances and returns the logical access clock used to rank data by coldness.
+        [[nodiscard]] std::uint64_t tick() noexcept { return ++clock_; }
+
+        /// @brief Issues a new, process-unique id (e.g. a chunk version).
+        [[nodiscard]] std::uint64_t next_id() noexcept { return ++last_id_; }
+
+        /// @brief Spills the coldest data until the accounted bytes fit the budget.
+        /// @return True if the budget is met, false if the remaining data cannot be spilled.
+        bool enforce()
+        {
+            while (used_ > budget_)
+            {
+                spillable* coldest {};
+                std::uint64_t coldest_tick {};
+                for (spillable* const item: spillables_)
+                {
+                    const auto access = item->coldest_access();
+                    if (access && ((coldest == nullptr) || (*access < coldest_tick)))
+                    {
+                        coldest = item;
+                        coldest_tick = *access;
+                    }
+                }
+
+                if ((coldest == nullptr) || (coldest->spill_coldest() == 0u))
+                    return false;
+                ++spills_;
+            }
+
+            return true;
+        }
+
+        /// @brief Gets the accounted bytes.
+        [[nodiscard]] std::size_t used() const noexcept { return used_; }
+
+        /// @brief Gets the memory budget in bytes.
+        [[nodiscard]] std::size_t budget() const noexcept { return budget_; }
+
+        /// @brief Changes the memory budget; call `enforce` to apply a lower one.
+        void set_budget(const std::size_t budget) noexcept { budget_ = budget; }
+
+        /// @brief Gets the number of chunks spilled so far.
+        [[nodiscard]] std::uint64_t spills() const noexcept { return spills_; }
+
+    private:
+        std::size_t budget_;
+        std::size_t used_ {};
+        std::uint64_t clock_ {};
+        std::uint64_t last_id_ {};
+        std::uint64_t spills_ {};
+        std::vector<spillable*> spillables_;
+    };
+
+} // namespace sensor::storage
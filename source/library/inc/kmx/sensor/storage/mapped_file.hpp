@@ -0,0 +1,155 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/storage/mapped_file.hpp
+/// @brief Defines a read-only memory-mapped file and a helper writing a file from several buffers.
+#pragma once
+#ifndef PCH
+    #include <cerrno>
+    #include <cstddef>
+    #include <filesystem>
+    #include <initializer_list>
+    #include <optional>
+    #include <span>
+    #include <utility>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace kmx::sensor::storage
+{
+    /// @brief Flushes a directory's entries (e.g. a new or renamed file name) to storage.
+    /// @param directory The directory; empty for the current one.
+    /// @return True on success, false on any I/O error.
+    inline bool sync_directory(const std::filesystem::path& directory) noexcept
+    {
+        const int descriptor = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (descriptor < 0)
+            return false;
+
+        const bool ok = ::fsync(descriptor) == 0;
+        return (::close(descriptor) == 0) && ok;
+    }
+
+    /// @brief Writes a file consisting of the concatenation of several buffers, replacing any existing file.
+    /// @details The data is written to a temporary sibling first and then renamed into place, so readers
+    ///          never observe a partially written file. The file is synced before the rename and its directory
+    ///          after it, so once this returns true the new contents survive a power loss under the name.
+    /// @param path The file to write.
+    /// @param parts The buffers to write, in order.
+    /// @return True on success, false on any I/O error.
+    inline bool write_file(const std::filesystem::path& path, const std::initializer_list<std::span<const std::byte>> parts) noexcept
+    {
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        const int descriptor = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (descriptor < 0)
+            return false;
+
+        bool ok = true;
+        for (const auto part: parts)
+        {
+            for (std::size_t written {}; ok && (written < part.size());)
+            {
+                const ::ssize_t result = ::write(descriptor, part.data() + written, part.size() - written);
+                if ((result < 0) && (errno == EINTR))
+                    continue;
+                ok = result > 0;
+                written += ok ? static_cast<std::size_t>(result) : 0u;
+            }
+        }
+
+        ok = ok && (::fsync(descriptor) == 0);
+        ok = (::close(descriptor) == 0) && ok;
+        if (ok)
+            ok = ::rename(temporary.c_str(), path.c_str()) == 0;
+        if (!ok)
+        {
+            ::unlink(temporary.c_str());
+            return false;
+        }
+
+        return sync_directory(path.parent_path());
+    }
+
+    /// @brief A read-only, private memory mapping of a whole file.
+    /// @details Pages are loaded lazily by the kernel and can be dropped by it at any time, so mapped
+    ///          data does not count against the process' own memory budget.
+    class mapped_file
+    {
+    public:
+        /// @brief Default constructor. Creates an empty mapping.
+        mapped_file() noexcept = default;
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& other) noexcept:
+            data_ {std::exchange(other.data_, nullptr)}, size_ {std::exchange(other.size_, 0u)}
+        {
+        }
+
+        mapped_file& operator=(mapped_file&& other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0u);
+            }
+
+            return *this;
+        }
+
+        ~mapped_file() noexcept { unmap(); }
+
+        /// @brief Maps a file into memory.
+        /// @param path The file to map.
+        /// @return The mapping, or an empty optional if the file cannot be opened or mapped.
+        [[nodiscard]] static std::optional<mapped_file> open(const std::filesystem::path& path) noexcept
+        {
+            const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (descriptor < 0)
+                return {};
+
+            struct ::stat status {};
+            std::optional<mapped_file> result;
+            if (::fstat(descriptor, &status) == 0)
+            {
+                const auto size = static_cast<std::size_t>(status.st_size);
+                void* const address = (size > 0u) ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0) : nullptr;
+                if (address != MAP_FAILED)
+                {
+                    result.emplace();
+                    result->data_ = static_cast<std::byte*>(address);
+                    result->size_ = size;
+                }
+            }
+
+            ::close(descriptor);
+            return result;
+        }
+
+        /// @brief Gets the mapped bytes.
+        [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+
+        /// @brief Gets the size of the mapping in bytes.
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+        /// @brief Checks whether a file is mapped.
+        [[nodiscard]] explicit operator bool() const noexcept { return data_ != nullptr; }
+
+    private:
+        void unmap() noexcept
+        {
+            if (data_ != nullptr)
+                ::munmap(data_, size_);
+            data_ = nullptr;
+            size_ = 0u;
+        }
+
+        std::byte* data_ {};
+        std::size_t size_ {};
+    };
+
+} // namespace sensor::storage
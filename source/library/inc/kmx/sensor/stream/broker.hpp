@@ -0,0 +1,380 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/stream/broker.hpp
+/// @brief Defines an in-process publish/subscribe broker that fans immutable, reference-counted
+/// batches of sensor readings out to many consumers without copying them.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/sample.hpp>
+    #include <algorithm>
+    #include <array>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <deque>
+    #include <memory>
+    #include <mutex>
+    #include <optional>
+    #include <span>
+    #include <string>
+    #include <string_view>
+    #include <unordered_map>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::stream
+{
+    /// @brief A coarse bitmap of the sensor ids in a batch or filter: bit `(id >> 6) % 1024`.
+    /// @details Two summaries that share no bit cannot share an id, so most non-matching batches are
+    ///          skipped with 16 word ANDs instead of a per-reading lookup.
+    using id_summary = std::array<std::uint64_t, 16u>;
+
+    /// @brief Sets the summary bit of a sensor id.
+    constexpr void summarize(id_summary& summary, const data::sensor_id sensor) noexcept
+    {
+        const std::uint32_t bit = (sensor >> 6u) & 1023u;
+        summary[bit >> 6u] |= std::uint64_t {1u} << (bit & 63u);
+    }
+
+    /// @brief An immutable batch of readings of one sensor type, shared by all subscribers.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class batch
+    {
+    public:
+        using storage_type = typename traits::storage_type;
+
+        /// @brief Constructor; the columns must have the same length.
+        batch(std::vector<data::sensor_id> sensors, std::vector<data::timestamp> times, std::vector<storage_type> values):
+            sensors_ {std::move(sensors)}, times_ {std::move(times)}, values_ {std::move(values)}
+        {
+            for (const data::sensor_id sensor: sensors_)
+                summarize(summary_, sensor);
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return sensors_.size(); }
+        [[nodiscard]] std::span<const data::sensor_id> sensors() const noexcept { return sensors_; }
+        [[nodiscard]] std::span<const data::timestamp> times() const noexcept { return times_; }
+        [[nodiscard]] std::span<const storage_type> values() const noexcept { return values_; }
+
+        /// @brief Gets the coarse bitmap of the sensor ids in the batch.
+        [[nodiscard]] const id_summary& summary() const noexcept { return summary_; }
+
+    private:
+        std::vector<data::sensor_id> sensors_;
+        std::vector<data::timestamp> times_;
+        std::vector<storage_type> values_;
+        id_summary summary_ {};
+    };
+
+    /// @brief A shared handle to an immutable batch.
+    template <typename traits>
+    using batch_ptr = std::shared_ptr<const batch<traits>>;
+
+    /// @brief Selects the sensor ids a subscriber is interested in.
+    class sensor_filter
+    {
+    public:
+        /// @brief Constructor of a filter matching every sensor.
+        sensor_filter() noexcept = default;
+
+        /// @brief Constructor of a filter matching a set of sensor ids.
+        explicit sensor_filter(const std::span<const data::sensor_id> sensors): all_ {false}
+        {
+            for (const data::sensor_id sensor: sensors)
+            {
+                if (sensor / 64u >= bits_.size())
+                    bits_.resize((sensor / 64u) + 1u);
+                bits_[sensor / 64u] |= std::uint64_t {1u} << (sensor % 64u);
+                summarize(summary_, sensor);
+            }
+        }
+
+        /// @brief Checks whether the filter matches every sensor.
+        [[nodiscard]] bool all() const noexcept { return all_; }
+
+        /// @brief Checks whether the filter matches a sensor id.
+        [[nodiscard]] bool matches(const data::sensor_id sensor) const noexcept
+        {
+            return all_ || ((sensor / 64u < bits_.size()) && (((bits_[sensor / 64u] >> (sensor % 64u)) & 1u) != 0u));
+        }
+
+        /// @brief Checks whether a batch with the given id summary may hold a matching reading.
+        [[nodiscard]] bool may_match(const id_summary& summary) const noexcept
+        {
+            if (all_)
+                return true;
+            std::uint64_t common {};
+            for (std::size_t i {}; i < summary.size(); ++i)
+                common |= summary[i] & summary_[i];
+            return common != 0u;
+        }
+
+    private:
+        bool all_ = true;
+        std::vector<std::uint64_t> bits_;
+        id_summary summary_ {};
+    };
+
+    /// @brief What a publisher does when a subscriber's queue is full.
+    enum class overflow_policy : std::uint8_t
+    {
+        block,       ///< Wait until the subscriber makes room; slows the publisher down to the slowest consumer.
+        drop_newest, ///< Discard the batch being published for this subscriber.
+        drop_oldest, ///< Discard the oldest queued batch of this subscriber to make room.
+    };
+
+    /// @brief The queue shared by a topic and one subscriber.
+    template <typename traits>
+    class subscriber_queue
+    {
+    public:
+        subscriber_queue(sensor_filter filter, const std::size_t capacity, const overflow_policy policy):
+            filter_ {std::move(filter)}, capacity_ {std::max<std::size_t>(capacity, 1u)}, policy_ {policy}
+        {
+        }
+
+        /// @brief Offers a batch; returns false if it was dropped or the queue is closed.
+        bool push(const batch_ptr<traits>& item)
+        {
+            if (!filter_.may_match(item->summary()))
+                return false;
+
+            std::unique_lock lock {mutex_};
+            if (queue_.size() >= capacity_)
+            {
+                if (policy_ == overflow_policy::drop_newest)
+                {
+                    ++dropped_;
+                    return false;
+                }
+
+                if (policy_ == overflow_policy::drop_oldest)
+                {
+                    queue_.pop_front();
+                    ++dropped_;
+                }
+                else
+                    not_full_.wait(lock, [this] { return closed_ || (queue_.size() < capacity_); });
+            }
+
+            if (closed_)
+                return false;
+
+            queue_.push_back(item);
+            lock.unlock();
+            not_empty_.notify_one();
+            return true;
+        }
+
+        /// @brief Takes the oldest batch, waiting for one unless `wait` is false.
+        /// @return The batch, or an empty optional if the queue is closed (or empty and `wait` is false).
+        std::optional<batch_ptr<traits>> pop(const bool wait)
+        {
+            std::unique_lock lock {mutex_};
+            if (wait)
+                not_empty_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+            if (queue_.empty())
+                return {};
+
+            batch_ptr<traits> item = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+            not_full_.notify_one();
+            return item;
+        }
+
+        /// @brief Closes the queue, waking up a waiting publisher and subscriber.
+        void close()
+        {
+            {
+                const std::lock_guard lock {mutex_};
+                closed_ = true;
+            }
+            not_empty_.notify_all();
+            not_full_.notify_all();
+        }
+
+        [[nodiscard]] bool closed() const
+        {
+            const std::lock_guard lock {mutex_};
+            return closed_;
+        }
+
+        [[nodiscard]] std::uint64_t dropped() const
+        {
+            const std::lock_guard lock {mutex_};
+            return dropped_;
+        }
+
+        [[nodiscard]] const sensor_filter& filter() const noexcept { return filter_; }
+
+    private:
+        const sensor_filter filter_;
+        const std::size_t capacity_;
+        const overflow_policy policy_;
+        mutable std::mutex mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::deque<batch_ptr<traits>> queue_;
+        std::uint64_t dropped_ {};
+        bool closed_ {};
+    };
+
+    /// @brief A consumer's handle to its queue; unsubscribes when destroyed.
+    template <typename traits>
+    class subscription
+    {
+    public:
+        explicit subscription(std::shared_ptr<subscriber_queue<traits>> queue) noexcept: queue_ {std::move(queue)} {}
+
+        subscription(subscription&&) noexcept = default;
+
+        subscription& operator=(subscription&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (queue_)
+                    queue_->close();
+                queue_ = std::move(other.queue_);
+            }
+
+            return *this;
+        }
+
+        ~subscription()
+        {
+            if (queue_)
+                queue_->close();
+        }
+
+        /// @brief Waits for the next batch.
+        /// @return The batch, or an empty optional once the subscription or topic is closed.
+        [[nodiscard]] std::optional<batch_ptr<traits>> pop() { return queue_->pop(true); }
+
+        /// @brief Takes the next batch if one is queued.
+        [[nodiscard]] std::optional<batch_ptr<traits>> try_pop() { return queue_->pop(false); }
+
+        /// @brief Visits the readings of a batch that match the subscription's filter.
+        /// @param item The batch.
+        /// @param visit Callable `void(data::sensor_id, data::timestamp, storage_type)`.
+        template <typename function>
+        void for_each(const batch<traits>& item, function&& visit) const
+        {
+            const sensor_filter& filter = queue_->filter();
+            const auto sensors = item.sensors();
+            const auto times = item.times();
+            const auto values = item.values();
+            for (std::size_t i {}; i < item.size(); ++i)
+                if (filter.matches(sensors[i]))
+                    visit(sensors[i], times[i], values[i]);
+        }
+
+        /// @brief Gets the number of batches dropped because this subscriber fell behind.
+        [[nodiscard]] std::uint64_t dropped() const { return queue_->dropped(); }
+
+        /// @brief Stops receiving batches.
+        void close() { queue_->close(); }
+
+    private:
+        std::shared_ptr<subscriber_queue<traits>> queue_;
+    };
+
+    /// @brief A stream of batches of one sensor type with any number of subscribers.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class topic
+    {
+    public:
+        using storage_type = typename traits::storage_type;
+
+        /// @brief Subscribes to the topic.
+        /// @param filter The sensor ids of interest.
+        /// @param capacity The number of batches the subscriber may fall behind.
+        /// @param policy What happens when it falls further behind.
+        [[nodiscard]] subscription<traits> subscribe(sensor_filter filter = {}, const std::size_t capacity = 64u,
+                                                     const overflow_policy policy = overflow_policy::block)
+        {
+            auto queue = std::make_shared<subscriber_queue<traits>>(std::move(filter), capacity, policy);
+            const std::lock_guard lock {mutex_};
+            queues_.push_back(queue);
+            return subscription<traits> {std::move(queue)};
+        }
+
+        /// @brief Shares a batch with every subscriber whose filter may match it.
+        /// @details The batch is pushed outside the topic's lock: a blocking push to a stalled subscriber must
+        ///          not keep `close()`, `subscribe()` or `subscribers()` waiting.
+        /// @return The number of subscribers the batch was delivered to.
+        std::size_t publish(const batch_ptr<traits>& item)
+        {
+            std::vector<std::shared_ptr<subscriber_queue<traits>>> queues;
+            {
+                const std::lock_guard lock {mutex_};
+                std::erase_if(queues_, [](const auto& queue) { return queue->closed(); });
+                queues = queues_;
+            }
+
+            std::size_t delivered {};
+            for (const auto& queue: queues)
+                delivered += queue->push(item) ? 1u : 0u;
+            return delivered;
+        }
+
+        /// @brief Publishes a newly built batch.
+        std::size_t publish(batch<traits>&& item) { return publish(std::make_shared<const batch<traits>>(std::move(item))); }
+
+        /// @brief Gets the number of open subscriptions.
+        [[nodiscard]] std::size_t subscribers() const
+        {
+            const std::lock_guard lock {mutex_};
+            return static_cast<std::size_t>(std::ranges::count_if(queues_, [](const auto& queue) { return !queue->closed(); }));
+        }
+
+        /// @brief Closes every subscription; their `pop()` returns an empty optional once drained.
+        void close()
+        {
+            const std::lock_guard lock {mutex_};
+            for (const auto& queue: queues_)
+                queue->close();
+            queues_.clear();
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        std::vector<std::shared_ptr<subscriber_queue<traits>>> queues_;
+    };
+
+    /// @brief A registry of named topics of different sensor types.
+    class broker
+    {
+    public:
+        /// @brief Gets or creates the topic of a name.
+        /// @return The topic, or nullptr if the name is already used by a topic of another sensor type.
+        template <typename traits>
+        [[nodiscard]] std::shared_ptr<stream::topic<traits>> topic(const std::string_view name)
+        {
+            const std::lock_guard lock {mutex_};
+            auto it = topics_.find(std::string {name});
+            if (it == topics_.end())
+                it = topics_.emplace(std::string {name}, entry {&type_tag<traits>, std::make_shared<stream::topic<traits>>()}).first;
+            if (it->second.type != &type_tag<traits>)
+                return nullptr;
+            return std::static_pointer_cast<stream::topic<traits>>(it->second.item);
+        }
+
+    private:
+        // One distinct address per sensor type identifies a topic's type without RTTI.
+        template <typename traits>
+        static constexpr char type_tag {};
+
+        struct entry
+        {
+            const void* type;
+            std::shared_ptr<void> item;
+        };
+
+        std::mutex mutex_;
+        std::unordered_map<std::string, entry> topics_;
+    };
+
+} // namespace sensor::stream
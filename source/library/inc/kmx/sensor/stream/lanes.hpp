@@ -0,0 +1,174 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/stream/lanes.hpp
+/// @brief Defines an ingestion queue with priority lanes and a weighted round-robin scheduler, so
+/// readings of critical sensors reach consumers with bounded delay even under bulk load.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/replication/segment.hpp>
+    #include <kmx/sensor/stream/broker.hpp>
+    #include <algorithm>
+    #include <condition_variable>
+    #include <cstddef>
+    #include <cstdint>
+    #include <deque>
+    #include <mutex>
+    #include <optional>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::stream
+{
+    /// @brief The configuration of one lane.
+    struct lane_config
+    {
+        /// @brief The number of consecutive batches the lane may deliver per scheduling round.
+        std::uint32_t weight = 1u;
+        /// @brief The largest number of readings delivered as one batch.
+        std::size_t batch_rows = 1024u;
+        /// @brief The number of queued readings at which producers of the lane are held back.
+        std::size_t capacity = std::size_t {1u} << 20u;
+    };
+
+    /// @brief A multi-producer, single-consumer queue of readings split into priority lanes.
+    /// @details Lanes are served in weighted round-robin order: lane i delivers up to `weight` batches of
+    ///          up to `batch_rows` readings before the next non-empty lane gets its turn, and empty lanes
+    ///          are skipped. A reading in a lane therefore waits at most for the batches of one round of
+    ///          the other lanes, i.e. sum(weight * batch_rows) readings, no matter how many bulk readings
+    ///          are queued; bulk lanes still deliver full batches. Readings are routed to lane 0 when their
+    ///          sensor is flagged critical, so lane 0 should be configured with a small batch size.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    class priority_lanes
+    {
+    public:
+        using record_type = replication::record<traits>;
+
+        /// @brief Constructor.
+        /// @param lanes The configuration of each lane; lane 0 receives the readings of critical sensors.
+        ///              A capacity or batch size of 0 is raised to 1.
+        explicit priority_lanes(const std::span<const lane_config> lanes): lanes_(std::max<std::size_t>(lanes.size(), 1u))
+        {
+            for (std::size_t i {}; i < lanes.size(); ++i)
+                lanes_[i].config = lanes[i];
+            for (lane& item: lanes_)
+            {
+                item.config.batch_rows = std::max<std::size_t>(item.config.batch_rows, 1u);
+                item.config.capacity = std::max<std::size_t>(item.config.capacity, 1u);
+                item.credits = std::max(item.config.weight, 1u);
+            }
+        }
+
+        /// @brief Gets the number of lanes.
+        [[nodiscard]] std::size_t lanes() const noexcept { return lanes_.size(); }
+
+        /// @brief Sets the sensors whose readings are routed to lane 0, e.g. from the sensor catalog.
+        void set_critical(sensor_filter critical)
+        {
+            const std::lock_guard lock {mutex_};
+            critical_ = std::move(critical);
+        }
+
+        /// @brief Queues readings in a lane, or in lane 0 for readings of critical sensors.
+        /// @details Blocks while the lane is full, so bulk producers are held back rather than dropped.
+        /// @param index The lane of non-critical readings (e.g. the backfill lane).
+        /// @param records The readings.
+        /// @return False if the queue was closed, true otherwise.
+        bool push(const std::size_t index, const std::span<const record_type> records)
+        {
+            std::unique_lock lock {mutex_};
+            lane& target = lanes_[std::min(index, lanes_.size() - 1u)];
+            for (const record_type& item: records)
+            {
+                lane& destination = (critical_ && critical_->matches(item.sensor)) ? lanes_.front() : target;
+                if (destination.queue.size() >= destination.config.capacity)
+                {
+                    not_empty_.notify_one();
+                    not_full_.wait(lock, [&] { return closed_ || (destination.queue.size() < destination.config.capacity); });
+                }
+                if (closed_)
+                    return false;
+
+                destination.queue.push_back(item);
+                ++queued_;
+            }
+
+            lock.unlock();
+            not_empty_.notify_one();
+            return true;
+        }
+
+        /// @brief Queues one reading.
+        bool push(const std::size_t index, const record_type& item) { return push(index, std::span<const record_type> {&item, 1u}); }
+
+        /// @brief Takes the next batch according to the schedule, waiting for readings.
+        /// @param output The vector the batch replaces.
+        /// @return The lane the batch came from, or an empty optional once the queue is closed and drained.
+        std::optional<std::size_t> pop(std::vector<record_type>& output)
+        {
+            std::unique_lock lock {mutex_};
+            not_empty_.wait(lock, [this] { return closed_ || (queued_ > 0u); });
+            if (queued_ == 0u)
+                return {};
+
+            while (lanes_[cursor_].queue.empty())
+                advance();
+
+            lane& source = lanes_[cursor_];
+            const std::size_t count = std::min(source.queue.size(), source.config.batch_rows);
+            output.assign(source.queue.begin(), source.queue.begin() + static_cast<std::ptrdiff_t>(count));
+            source.queue.erase(source.queue.begin(), source.queue.begin() + static_cast<std::ptrdiff_t>(count));
+            queued_ -= count;
+
+            const std::size_t served = cursor_;
+            if (--source.credits == 0u)
+                advance();
+
+            lock.unlock();
+            not_full_.notify_all();
+            return served;
+        }
+
+        /// @brief Gets the number of queued readings of a lane.
+        [[nodiscard]] std::size_t queued(const std::size_t index) const
+        {
+            const std::lock_guard lock {mutex_};
+            return lanes_[index].queue.size();
+        }
+
+        /// @brief Closes the queue; producers stop and the consumer drains what is queued.
+        void close()
+        {
+            {
+                const std::lock_guard lock {mutex_};
+                closed_ = true;
+            }
+            not_empty_.notify_all();
+            not_full_.notify_all();
+        }
+
+    private:
+        struct lane
+        {
+            lane_config config;
+            std::uint32_t credits {};
+            std::deque<record_type> queue;
+        };
+
+        void advance() noexcept
+        {
+            lanes_[cursor_].credits = std::max(lanes_[cursor_].config.weight, 1u);
+            cursor_ = (cursor_ + 1u) % lanes_.size();
+        }
+
+        mutable std::mutex mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::vector<lane> lanes_;
+        std::optional<sensor_filter> critical_;
+        std::size_t cursor_ {};
+        std::size_t queued_ {};
+        bool closed_ {};
+    };
+
+} // namespace sensor::stream
@@ -0,0 +1,182 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/sync/merkle.hpp
+/// @brief Defines content fingerprints of fixed time chunks of sensor data arranged in a
+/// time-ordered Merkle tree, and a level-by-level diff that finds the chunks two stores disagree on.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/codec/hash.hpp>
+    #include <kmx/sensor/data/sample.hpp>
+    #include <algorithm>
+    #include <bit>
+    #include <concepts>
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #include <utility>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::sync
+{
+    /// @brief Accumulates content hashes of readings into fixed-width time chunks.
+    /// @details Chunk `i` covers [origin + i * width, origin + (i + 1) * width). A chunk's hash is the
+    ///          wrapping sum of per-reading hashes, so it depends only on the readings it contains and not
+    ///          on how they are split into columns, files or spilled chunks, and it can be updated
+    ///          incrementally. Both stores must use the same origin, width and chunk count.
+    class chunk_hasher
+    {
+    public:
+        /// @brief Constructor.
+        /// @param origin The start of the first time chunk.
+        /// @param width The width of each time chunk in ticks (must be positive).
+        /// @param chunks The number of time chunks.
+        chunk_hasher(const data::timestamp origin, const data::timestamp width, const std::size_t chunks):
+            origin_ {origin}, width_ {width}, sums_(chunks), counts_(chunks)
+        {
+        }
+
+        /// @brief Adds a slice of readings (e.g. one sealed chunk or archive block) to the hashes.
+        /// @details Readings outside the covered time range are ignored.
+        /// @param times The timestamps of the readings.
+        /// @param values The raw scaled values of the readings; integer storage only, as the hashes are taken
+        ///               over the values as 64-bit integers.
+        template <std::integral storage_type>
+        void add(const std::span<const data::timestamp> times, const std::span<const storage_type> values) noexcept
+        {
+            const std::size_t count = std::min(times.size(), values.size());
+            for (std::size_t i {}; i < count; ++i)
+            {
+                if (times[i] < origin_)
+                    continue;
+                const auto index = static_cast<std::size_t>((times[i] - origin_) / width_);
+                if (index >= sums_.size())
+                    continue;
+
+                sums_[index] += reading_hash(times[i], static_cast<std::int64_t>(values[i]));
+                ++counts_[index];
+            }
+        }
+
+        /// @brief Gets the content hash of every time chunk (0 for empty chunks).
+        [[nodiscard]] std::vector<std::uint64_t> hashes() const
+        {
+            std::vector<std::uint64_t> result(sums_.size());
+            for (std::size_t i {}; i < sums_.size(); ++i)
+                result[i] = (counts_[i] == 0u) ? 0u : codec::mix(sums_[i] ^ codec::mix(counts_[i]));
+            return result;
+        }
+
+        /// @brief Gets the time range [from, to) covered by a chunk.
+        [[nodiscard]] std::pair<data::timestamp, data::timestamp> range(const std::size_t index) const noexcept
+        {
+            const data::timestamp from = origin_ + (static_cast<data::timestamp>(index) * width_);
+            return {from, from + width_};
+        }
+
+    private:
+        [[nodiscard]] static constexpr std::uint64_t reading_hash(const data::timestamp time, const std::int64_t value) noexcept
+        {
+            return codec::mix(static_cast<std::uint64_t>(time) ^ codec::mix(static_cast<std::uint64_t>(value) + 0x9e3779b97f4a7c15u));
+        }
+
+        data::timestamp origin_;
+        data::timestamp width_;
+        std::vector<std::uint64_t> sums_;
+        std::vector<std::uint64_t> counts_;
+    };
+
+    /// @brief A binary hash tree over time-ordered chunk hashes.
+    /// @details The leaves are padded with empty (0) hashes to a power of two. Level 0 holds the root and
+    ///          level `depth()` the leaves; node `i` of a level has children `2i` and `2i + 1`.
+    class merkle_tree
+    {
+    public:
+        /// @brief Constructor.
+        /// @param leaves The chunk hashes in time order.
+        explicit merkle_tree(const std::span<const std::uint64_t> leaves)
+        {
+            const std::size_t width = std::bit_ceil(std::max<std::size_t>(leaves.size(), 1u));
+            levels_.emplace_back(leaves.begin(), leaves.end());
+            levels_.back().resize(width);
+            while (levels_.back().size() > 1u)
+            {
+                const auto& below = levels_.back();
+                std::vector<std::uint64_t> above(below.size() / 2u);
+                for (std::size_t i {}; i < above.size(); ++i)
+                    above[i] = combine(below[2u * i], below[(2u * i) + 1u]);
+                levels_.push_back(std::move(above));
+            }
+
+            std::ranges::reverse(levels_);
+        }
+
+        /// @brief Gets the root hash; equal roots mean equal content.
+        [[nodiscard]] std::uint64_t root() const noexcept { return levels_.front().front(); }
+
+        /// @brief Gets the number of levels below the root.
+        [[nodiscard]] std::size_t depth() const noexcept { return levels_.size() - 1u; }
+
+        /// @brief Gets the hashes of one level.
+        [[nodiscard]] std::span<const std::uint64_t> level(const std::size_t index) const noexcept { return levels_[index]; }
+
+        /// @brief Gets the hashes of selected nodes of one level, e.g. to answer a remote diff request.
+        /// @param index The level.
+        /// @param nodes The node positions within the level.
+        [[nodiscard]] std::vector<std::uint64_t> nodes(const std::size_t index, const std::span<const std::size_t> nodes) const
+        {
+            std::vector<std::uint64_t> result;
+            result.reserve(nodes.size());
+            for (const std::size_t node: nodes)
+                result.push_back((node < levels_[index].size()) ? levels_[index][node] : 0u);
+            return result;
+        }
+
+    private:
+        [[nodiscard]] static constexpr std::uint64_t combine(const std::uint64_t left, const std::uint64_t right) noexcept
+        {
+            if ((left == 0u) && (right == 0u))
+                return 0u;
+            return codec::mix(left ^ codec::mix(right + 0x9e3779b97f4a7c15u));
+        }
+
+        std::vector<std::vector<std::uint64_t>> levels_;
+    };
+
+    /// @brief Finds the chunks whose content differs between a local tree and a remote one.
+    /// @details Descends both trees one level per round trip, only expanding nodes whose hashes differ,
+    ///          so k differing chunks out of n cost `depth()` = O(log n) round trips of at most 2k hashes.
+    /// @param local The local tree; the remote tree must have the same number of leaves.
+    /// @param fetch Callable `std::vector<std::uint64_t>(std::size_t level, std::span<const std::size_t> nodes)`
+    ///              returning the remote hashes of the given nodes (one round trip over the transport).
+    /// @return The indexes of the differing chunks, in time order.
+    template <typename fetch_function>
+    [[nodiscard]] std::vector<std::size_t> differing_chunks(const merkle_tree& local, fetch_function&& fetch)
+    {
+        std::vector<std::size_t> candidates {0u};
+        for (std::size_t level {}; level <= local.depth(); ++level)
+        {
+            const std::vector<std::uint64_t> remote = fetch(level, std::span<const std::size_t> {candidates});
+            const auto hashes = local.level(level);
+            std::vector<std::size_t> next;
+            for (std::size_t i {}; i < candidates.size(); ++i)
+            {
+                if ((i < remote.size()) && (remote[i] == hashes[candidates[i]]))
+                    continue;
+                if (level == local.depth())
+                    next.push_back(candidates[i]);
+                else
+                {
+                    next.push_back(2u * candidates[i]);
+                    next.push_back((2u * candidates[i]) + 1u);
+                }
+            }
+
+            candidates = std::move(next);
+            if (candidates.empty())
+                break;
+        }
+
+        return candidates;
+    }
+
+} // namespace sensor::sync
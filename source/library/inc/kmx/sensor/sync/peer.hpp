@@ -0,0 +1,98 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/sync/peer.hpp
+/// @brief Defines the request/response exchange of Merkle tree node hashes between two stores
+/// over a Unix domain socket.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/replication/link.hpp>
+    #include <kmx/sensor/sync/merkle.hpp>
+    #include <array>
+    #include <cstddef>
+    #include <cstdint>
+    #include <span>
+    #include <vector>
+#endif
+
+namespace kmx::sensor::sync
+{
+    /// @brief Views 64-bit words as the bytes sent over a socket.
+    [[nodiscard]] inline std::span<const std::uint8_t> word_bytes(const std::span<const std::uint64_t> words) noexcept
+    {
+        return {reinterpret_cast<const std::uint8_t*>(words.data()), words.size_bytes()};
+    }
+
+    /// @brief Views 64-bit words as the bytes received from a socket.
+    [[nodiscard]] inline std::span<std::uint8_t> writable_word_bytes(const std::span<std::uint64_t> words) noexcept
+    {
+        return {reinterpret_cast<std::uint8_t*>(words.data()), words.size_bytes()};
+    }
+
+    /// @brief Answers node hash requests about a local tree until the peer closes the connection.
+    /// @details A request is `{level, count}` followed by `count` node positions, all as 64-bit words;
+    ///          the response is `count` hashes. An empty request (`count == 0`) ends the session, and so
+    ///          does a malformed one (a level below the leaves, or more positions than the level has nodes),
+    ///          so that a corrupt or hostile peer cannot make the server allocate without bound.
+    /// @param connection The socket connected to the peer running `differing_chunks`.
+    /// @param tree The local tree.
+    /// @return The number of requests answered.
+    inline std::size_t serve(replication::unix_socket& connection, const merkle_tree& tree)
+    {
+        std::size_t answered {};
+        std::vector<std::uint64_t> positions;
+        while (true)
+        {
+            std::array<std::uint64_t, 2u> request;
+            if (!connection.receive_all(writable_word_bytes(request)) || (request[1] == 0u) ||
+                (request[0] > tree.depth()) || (request[1] > tree.level(static_cast<std::size_t>(request[0])).size()))
+                return answered;
+
+            positions.resize(request[1]);
+            if (!connection.receive_all(writable_word_bytes(positions)))
+                return answered;
+
+            std::vector<std::size_t> nodes(positions.begin(), positions.end());
+            const std::vector<std::uint64_t> hashes = tree.nodes(request[0], nodes);
+            if (!connection.send_all(word_bytes(hashes)))
+                return answered;
+            ++answered;
+        }
+    }
+
+    /// @brief A `differing_chunks` fetch function asking a peer running `serve` for its node hashes.
+    class remote_tree
+    {
+    public:
+        /// @brief Constructor.
+        /// @param connection The socket connected to the peer; must outlive this object.
+        explicit remote_tree(replication::unix_socket& connection) noexcept: connection_ {connection} {}
+
+        /// @brief Fetches the peer's hashes of selected nodes of one level in one round trip.
+        /// @return The hashes, or an empty vector if the connection failed (every node then counts as differing).
+        std::vector<std::uint64_t> operator()(const std::size_t level, const std::span<const std::size_t> nodes)
+        {
+            std::vector<std::uint64_t> request {level, nodes.size()};
+            request.insert(request.end(), nodes.begin(), nodes.end());
+            std::vector<std::uint64_t> hashes(nodes.size());
+            if (nodes.empty() || !connection_.send_all(word_bytes(request)) ||
+                !connection_.receive_all(writable_word_bytes(hashes)))
+                return {};
+            ++round_trips_;
+            return hashes;
+        }
+
+        /// @brief Ends the session of the serving peer.
+        void close()
+        {
+            const std::array<std::uint64_t, 2u> request {};
+            connection_.send_all(word_bytes(request));
+        }
+
+        /// @brief Gets the number of completed round trips.
+        [[nodiscard]] std::size_t round_trips() const noexcept { return round_trips_; }
+
+    private:
+        replication::unix_socket& connection_;
+        std::size_t round_trips_ {};
+    };
+
+} // namespace sensor::sync
@@ -0,0 +1,182 @@
+/// @copyright Copyright (c) 2025 - present KMX Systems. All rights reserved.
+/// @file sensor/views/adaptors.hpp
+/// @brief Defines lazy range adaptors over sensor readings, raw scaled columns and physical values, so
+/// conversions and filters compose without materializing intermediate vectors.
+#pragma once
+#ifndef PCH
+    #include <kmx/sensor/data/base.hpp>
+    #include <concepts>
+    #include <cstddef>
+    #include <limits>
+    #include <ranges>
+    #include <type_traits>
+    #include <utility>
+#endif
+
+namespace kmx::sensor::views
+{
+    /// @brief Satisfied by ranges of sensor objects of a sensor type (e.g. `data::temperature`).
+    template <typename range_type, typename traits>
+    concept reading_range = std::derived_from<std::remove_cvref_t<std::ranges::range_reference_t<range_type>>, data::base<traits>>;
+
+    /// @brief Satisfied by ranges of raw scaled values of a sensor type.
+    template <typename range_type, typename traits>
+    concept scaled_range = std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<range_type>>, typename traits::storage_type>;
+
+    /// @brief Satisfied by ranges of physical values of a sensor type.
+    template <typename range_type, typename traits>
+    concept physical_range = std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<range_type>>, typename traits::input_type>;
+
+    /// @brief Makes an adaptor usable as `range | adaptor` as well as `adaptor(range)`.
+    /// @details A stand-in for `std::ranges::range_adaptor_closure`, which not all supported standard
+    ///          libraries provide yet.
+    template <typename adaptor>
+    struct pipeable
+    {
+        template <std::ranges::viewable_range range_type>
+            requires std::invocable<const adaptor&, range_type>
+        [[nodiscard]] friend constexpr auto operator|(range_type&& values, const adaptor& self)
+        {
+            return self(std::forward<range_type>(values));
+        }
+    };
+
+    /// @brief The adaptor behind `views::physical`.
+    template <typename traits>
+    struct physical_adaptor: pipeable<physical_adaptor<traits>>
+    {
+        using sensor_type = data::base<traits>;
+        using storage_type = typename traits::storage_type;
+        using input_type = typename traits::input_type;
+
+        template <std::ranges::viewable_range range_type>
+            requires scaled_range<range_type, traits>
+        [[nodiscard]] constexpr auto operator()(range_type&& values) const
+        {
+            return std::views::transform(std::forward<range_type>(values),
+                                         [](const storage_type val) noexcept { return sensor_type::to_physical(val); });
+        }
+
+        template <std::ranges::viewable_range range_type>
+            requires reading_range<range_type, traits>
+        [[nodiscard]] constexpr auto operator()(range_type&& readings) const
+        {
+            return std::views::transform(std::forward<range_type>(readings),
+                                         [](const sensor_type& reading) noexcept
+                                         { return reading.value().value_or(std::numeric_limits<input_type>::quiet_NaN()); });
+        }
+    };
+
+    /// @brief The adaptor behind `views::scaled`.
+    template <typename traits>
+    struct scaled_adaptor: pipeable<scaled_adaptor<traits>>
+    {
+        using sensor_type = data::base<traits>;
+        using input_type = typename traits::input_type;
+
+        template <std::ranges::viewable_range range_type>
+            requires physical_range<range_type, traits>
+        [[nodiscard]] constexpr auto operator()(range_type&& values) const
+        {
+            return std::views::transform(std::forward<range_type>(values),
+                                         [](const input_type val) noexcept { return sensor_type::to_scaled(val); });
+        }
+
+        template <std::ranges::viewable_range range_type>
+            requires reading_range<range_type, traits>
+        [[nodiscard]] constexpr auto operator()(range_type&& readings) const
+        {
+            return std::forward<range_type>(readings) |
+                   std::views::filter([](const sensor_type& reading) noexcept { return static_cast<bool>(reading); }) |
+                   std::views::transform([](const sensor_type& reading) noexcept { return *reading.raw_scaled_value(); });
+        }
+    };
+
+    /// @brief The adaptor behind `views::valid_only`.
+    template <typename traits>
+    struct valid_only_adaptor: pipeable<valid_only_adaptor<traits>>
+    {
+        using sensor_type = data::base<traits>;
+        using storage_type = typename traits::storage_type;
+
+        template <std::ranges::viewable_range range_type>
+            requires scaled_range<range_type, traits>
+        [[nodiscard]] constexpr auto operator()(range_type&& values) const
+        {
+            return std::views::filter(std::forward<range_type>(values),
+                                      [](const storage_type val) noexcept
+                                      {
+                                          return (val >= sensor_type::min_scaled_storage_value()) &&
+                                                 (val <= sensor_type::max_scaled_storage_value());
+                                      });
+        }
+
+        template <std::ranges::viewable_range range_type>
+            requires reading_range<range_type, traits>
+        [[nodiscard]] constexpr auto operator()(range_type&& readings) const
+        {
+            return std::views::filter(std::forward<range_type>(readings),
+                                      [](const sensor_type& reading) noexcept { return static_cast<bool>(reading); });
+        }
+    };
+
+    /// @brief The adaptor behind `views::clamped_count`.
+    template <typename traits>
+    struct clamped_count_adaptor: pipeable<clamped_count_adaptor<traits>>
+    {
+        using input_type = typename traits::input_type;
+
+        template <std::ranges::viewable_range range_type>
+            requires physical_range<range_type, traits>
+        [[nodiscard]] constexpr std::size_t operator()(range_type&& values) const
+        {
+            const auto outside = [](const input_type val) noexcept
+            { return static_cast<std::size_t>((val < traits::min_value) | (val > traits::max_value)); };
+
+            std::size_t total {};
+            if constexpr (std::ranges::contiguous_range<range_type> && std::ranges::sized_range<range_type>)
+            {
+                // An indexed loop over the underlying array is the form vectorizers handle best.
+                const input_type* const data = std::ranges::data(values);
+                const auto count = static_cast<std::size_t>(std::ranges::size(values));
+                for (std::size_t i {}; i < count; ++i)
+                    total += outside(data[i]);
+            }
+            else
+                for (const input_type val: values)
+                    total += outside(val);
+            return total;
+        }
+    };
+
+    /// @brief Converts lazily to physical values.
+    /// @details Over raw scaled values, each becomes `base<traits>::to_physical(value)`. Over sensor objects,
+    ///          each defined reading becomes its value and each undefined one a quiet NaN; put `valid_only`
+    ///          first to drop them instead. Keeps the random access and size of the underlying range.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    inline constexpr physical_adaptor<traits> physical {};
+
+    /// @brief Converts lazily to raw scaled values.
+    /// @details Over physical values, each becomes `base<traits>::to_scaled(value)`, i.e. is clamped and
+    ///          rounded. Over sensor objects, the raw scaled values of the defined readings are produced.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    inline constexpr scaled_adaptor<traits> scaled {};
+
+    /// @brief Filters lazily to valid elements: raw scaled values within the sensor's scaled range, or
+    ///        defined sensor objects.
+    /// @details Like any filter, it costs a branch per element and drops random access; to check whole
+    ///          columns with many invalid values, `data::validate()` is faster.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    inline constexpr valid_only_adaptor<traits> valid_only {};
+
+    /// @brief Counts the physical values that `scaled` would clamp, i.e. that lie outside [min, max].
+    /// @details A reduction rather than a view: `values | views::clamped_count<traits>` is a number. NaNs are
+    ///          not counted. Contiguous ranges are scanned with a plain indexed loop.
+    /// @tparam traits The sensor traits.
+    template <typename traits>
+    inline constexpr clamped_count_adaptor<traits> clamped_count {};
+
+} // namespace sensor::views